@@ -1,5 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define SEGMENT_TREE_EMPTY_MIN (LLONG_MAX / 4) // min of an empty range, far from overflow when added to
 
 // array class
 typedef struct Array {
@@ -135,6 +139,441 @@ void delete_element(Array *arr, int index) {
     }
 }
 
+// point update for fenwick_apply_batch, delta is added to the element
+typedef struct ArrayDelta {
+    int index; // element to update
+    int delta; // amount added to the element
+} ArrayDelta;
+
+// point update for segment_tree_apply_batch, the element is replaced by value
+typedef struct ArrayAssignment {
+    int index; // element to update
+    int value; // new value of the element
+} ArrayAssignment;
+
+// helper to check if applying k updates one by one is slower than an O(n) rebuild
+static int batch_needs_rebuild(int count, int size) {
+    int log_size = 1;
+    while ((1 << log_size) < size) {
+        log_size++;
+    }
+    return (long)count * log_size > size;
+}
+
+/*
+Fenwick tree class (binary indexed tree) for range sums
+
+Node i (1-based) stores the sum of the (i & -i) elements ending at i, so a prefix sum
+adds up one node per set bit of the index and an update touches one node per level.
+Range-add uses two more trees: adding v to [l, r] is stored as differences, and
+prefix_sum(i) = base(i) + add(i) * i - correction(i).
+*/
+typedef struct FenwickTree {
+    long long *base; // sums of the original values plus point updates
+    long long *add; // differences of range adds
+    long long *correction; // differences of range adds multiplied by their start
+    int size; // number of elements
+} FenwickTree;
+
+/*
+method to build Fenwick tree from array
+
+Create Fenwick tree:
+    Time Complexity: O(n)
+    Space Complexity: O(n)
+    Instead of n updates (O(n log n)) each node adds its finished sum to its parent
+    i + (i & -i) once, left to right.
+*/
+FenwickTree create_fenwick_tree(Array arr) {
+    FenwickTree ft;
+    ft.size = arr.size;
+    ft.base = (long long*)malloc((arr.size + 1) * sizeof(long long));
+    ft.add = (long long*)calloc(arr.size + 1, sizeof(long long));
+    ft.correction = (long long*)calloc(arr.size + 1, sizeof(long long));
+
+    ft.base[0] = 0;
+    for (int i = 1; i <= arr.size; i++) {
+        ft.base[i] = arr.data[i - 1];
+    }
+    for (int i = 1; i <= arr.size; i++) {
+        int parent = i + (i & -i);
+        if (parent <= arr.size) {
+            ft.base[parent] += ft.base[i];
+        }
+    }
+    return ft;
+}
+
+// method to free Fenwick tree
+void free_fenwick_tree(FenwickTree *ft) {
+    free(ft->base);
+    free(ft->add);
+    free(ft->correction);
+    ft->size = 0;
+}
+
+// helpers for one binary indexed tree, i is 1-based
+static void fenwick_update(long long *tree, int size, int i, long long delta) {
+    for (; i <= size; i += i & -i) {
+        tree[i] += delta;
+    }
+}
+
+static long long fenwick_prefix(const long long *tree, int i) {
+    long long sum = 0;
+    for (; i > 0; i -= i & -i) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+// helper for the sum of the first count elements
+static long long fenwick_prefix_sum(const FenwickTree *ft, int count) {
+    return fenwick_prefix(ft->base, count) + fenwick_prefix(ft->add, count) * count
+        - fenwick_prefix(ft->correction, count);
+}
+
+/*
+method to add delta to one element
+
+Fenwick point add:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+*/
+void fenwick_point_add(FenwickTree *ft, int index, long long delta) {
+    if (index < 0 || index >= ft->size) {
+        printf("\nInvalid index.");
+        return;
+    }
+    fenwick_update(ft->base, ft->size, index + 1, delta);
+}
+
+/*
+method to add delta to every element in [left, right]
+
+Fenwick range add:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    Four tree updates instead of right - left + 1 point updates.
+*/
+void fenwick_range_add(FenwickTree *ft, int left, int right, long long delta) {
+    if (left < 0 || right >= ft->size || left > right) {
+        printf("\nInvalid range.");
+        return;
+    }
+    fenwick_update(ft->add, ft->size, left + 1, delta);
+    fenwick_update(ft->add, ft->size, right + 2, -delta);
+    fenwick_update(ft->correction, ft->size, left + 1, delta * left);
+    fenwick_update(ft->correction, ft->size, right + 2, -delta * (right + 1));
+}
+
+/*
+method to return the sum of the elements in [left, right]
+
+Fenwick range sum:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+*/
+long long fenwick_range_sum(const FenwickTree *ft, int left, int right) {
+    if (left < 0 || right >= ft->size || left > right) {
+        printf("\nInvalid range.");
+        return 0;
+    }
+    return fenwick_prefix_sum(ft, right + 1) - fenwick_prefix_sum(ft, left);
+}
+
+/*
+method to add many deltas at once (delta.delta is added to element delta.index)
+
+Fenwick batch add:
+    Time Complexity: O(min(k log n, n + k)) for k updates
+    Space Complexity: O(1)
+    Small batches are applied one by one. For a large batch the base tree is turned back
+    into plain values in O(n) (the construction run backwards), the deltas are added
+    directly and the tree is rebuilt in O(n).
+*/
+void fenwick_apply_batch(FenwickTree *ft, const ArrayDelta *deltas, int count) {
+    if (!batch_needs_rebuild(count, ft->size)) {
+        for (int i = 0; i < count; i++) {
+            fenwick_point_add(ft, deltas[i].index, deltas[i].delta);
+        }
+        return;
+    }
+
+    for (int i = ft->size; i >= 1; i--) {
+        int parent = i + (i & -i);
+        if (parent <= ft->size) {
+            ft->base[parent] -= ft->base[i];
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (deltas[i].index >= 0 && deltas[i].index < ft->size) {
+            ft->base[deltas[i].index + 1] += deltas[i].delta;
+        }
+    }
+    for (int i = 1; i <= ft->size; i++) {
+        int parent = i + (i & -i);
+        if (parent <= ft->size) {
+            ft->base[parent] += ft->base[i];
+        }
+    }
+}
+
+/*
+segment tree class for range sums and range minimums (iterative, bottom-up)
+
+The tree is one implicit array: node p has children 2p and 2p + 1, and the leaves are
+nodes leaves ... 2 * leaves - 1, where leaves is the array size rounded up to a power of
+two. There are no child pointers and queries walk up from the two leaves of the range
+instead of recursing down from the root.
+
+A range add stores the pending add in lazy[p] of the O(log n) nodes that cover the range
+instead of touching every leaf. Nodes always hold their correct sum and minimum including
+their own lazy value, and a query first pushes the pending adds of the ancestors of its
+two border leaves down.
+*/
+typedef struct SegmentTree {
+    long long *sum; // sum of the node's range
+    long long *min; // minimum of the node's range
+    long long *lazy; // add still to be pushed to the children (inner nodes only)
+    int size; // number of elements
+    int leaves; // size rounded up to a power of two
+    int height; // log2(leaves)
+} SegmentTree;
+
+// helper to recompute the ancestors of node p from their children
+static void segment_tree_pull(SegmentTree *st, int p) {
+    long long width = 2;
+    while (p > 1) {
+        p >>= 1;
+        long long low = st->min[2 * p] < st->min[2 * p + 1] ? st->min[2 * p] : st->min[2 * p + 1];
+        st->min[p] = low + st->lazy[p];
+        st->sum[p] = st->sum[2 * p] + st->sum[2 * p + 1] + st->lazy[p] * width;
+        width <<= 1;
+    }
+}
+
+// helper to add value to node p that covers width elements
+static void segment_tree_apply(SegmentTree *st, int p, long long value, long long width) {
+    st->min[p] += value;
+    st->sum[p] += value * width;
+    if (p < st->leaves) {
+        st->lazy[p] += value;
+    }
+}
+
+// helper to push the pending adds of all ancestors of node p down, top first
+static void segment_tree_push(SegmentTree *st, int p) {
+    for (int shift = st->height; shift > 0; shift--) {
+        int i = p >> shift;
+        if (st->lazy[i] != 0) {
+            long long width = 1LL << (shift - 1);
+            segment_tree_apply(st, 2 * i, st->lazy[i], width);
+            segment_tree_apply(st, 2 * i + 1, st->lazy[i], width);
+            st->lazy[i] = 0;
+        }
+    }
+}
+
+// helper to compute every inner node from its children
+static void segment_tree_build(SegmentTree *st) {
+    for (int p = st->leaves - 1; p >= 1; p--) {
+        st->min[p] = st->min[2 * p] < st->min[2 * p + 1] ? st->min[2 * p] : st->min[2 * p + 1];
+        st->sum[p] = st->sum[2 * p] + st->sum[2 * p + 1];
+        st->lazy[p] = 0;
+    }
+}
+
+/*
+method to build segment tree from array
+
+Create segment tree:
+    Time Complexity: O(n)
+    Space Complexity: O(n)
+    The values are copied into the leaves and every inner node is computed once, from
+    the last one to the root.
+*/
+SegmentTree create_segment_tree(Array arr) {
+    SegmentTree st;
+    st.size = arr.size;
+    st.leaves = 1;
+    st.height = 0;
+    while (st.leaves < arr.size) {
+        st.leaves <<= 1;
+        st.height++;
+    }
+
+    st.sum = (long long*)malloc(2 * st.leaves * sizeof(long long));
+    st.min = (long long*)malloc(2 * st.leaves * sizeof(long long));
+    st.lazy = (long long*)calloc(st.leaves, sizeof(long long));
+
+    for (int i = 0; i < st.leaves; i++) {
+        // padding leaves don't change sums and never win a minimum
+        st.sum[st.leaves + i] = i < arr.size ? arr.data[i] : 0;
+        st.min[st.leaves + i] = i < arr.size ? arr.data[i] : SEGMENT_TREE_EMPTY_MIN;
+    }
+    segment_tree_build(&st);
+    return st;
+}
+
+// method to free segment tree
+void free_segment_tree(SegmentTree *st) {
+    free(st->sum);
+    free(st->min);
+    free(st->lazy);
+    st->size = 0;
+}
+
+/*
+method to set one element to a new value
+
+Segment tree set:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    Pending adds above the leaf are pushed first so the leaf holds its real value.
+*/
+void segment_tree_set(SegmentTree *st, int index, long long value) {
+    if (index < 0 || index >= st->size) {
+        printf("\nInvalid index.");
+        return;
+    }
+
+    int p = index + st->leaves;
+    segment_tree_push(st, p);
+    st->sum[p] = value;
+    st->min[p] = value;
+    segment_tree_pull(st, p);
+}
+
+/*
+method to add value to every element in [left, right]
+
+Segment tree range add:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    Walks up from both ends of the range. A node whose whole range is inside gets the
+    add (lazily for its subtree), then the ancestors of both ends are recomputed.
+*/
+void segment_tree_range_add(SegmentTree *st, int left, int right, long long value) {
+    if (left < 0 || right >= st->size || left > right) {
+        printf("\nInvalid range.");
+        return;
+    }
+
+    int l = left + st->leaves;
+    int r = right + 1 + st->leaves;
+    long long width = 1;
+
+    for (int lo = l, hi = r; lo < hi; lo >>= 1, hi >>= 1, width <<= 1) {
+        if (lo & 1) {
+            segment_tree_apply(st, lo++, value, width);
+        }
+        if (hi & 1) {
+            segment_tree_apply(st, --hi, value, width);
+        }
+    }
+    segment_tree_pull(st, l);
+    segment_tree_pull(st, r - 1);
+}
+
+// helper to walk up from both ends of [left, right] and combine the covering nodes
+static void segment_tree_query(SegmentTree *st, int left, int right, long long *sum, long long *min) {
+    int l = left + st->leaves;
+    int r = right + 1 + st->leaves;
+    segment_tree_push(st, l);
+    segment_tree_push(st, r - 1);
+
+    *sum = 0;
+    *min = SEGMENT_TREE_EMPTY_MIN;
+    for (; l < r; l >>= 1, r >>= 1) {
+        if (l & 1) {
+            *sum += st->sum[l];
+            *min = st->min[l] < *min ? st->min[l] : *min;
+            l++;
+        }
+        if (r & 1) {
+            r--;
+            *sum += st->sum[r];
+            *min = st->min[r] < *min ? st->min[r] : *min;
+        }
+    }
+}
+
+/*
+method to return the sum of the elements in [left, right]
+
+Segment tree range sum:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+*/
+long long segment_tree_range_sum(SegmentTree *st, int left, int right) {
+    if (left < 0 || right >= st->size || left > right) {
+        printf("\nInvalid range.");
+        return 0;
+    }
+
+    long long sum, min;
+    segment_tree_query(st, left, right, &sum, &min);
+    return sum;
+}
+
+/*
+method to return the minimum of the elements in [left, right]
+
+Segment tree range min:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+*/
+long long segment_tree_range_min(SegmentTree *st, int left, int right) {
+    if (left < 0 || right >= st->size || left > right) {
+        printf("\nInvalid range.");
+        return 0;
+    }
+
+    long long sum, min;
+    segment_tree_query(st, left, right, &sum, &min);
+    return min;
+}
+
+/*
+method to set many elements at once (element assignment.index becomes assignment.value)
+
+Segment tree batch set:
+    Time Complexity: O(min(k log n, n + k)) for k updates
+    Space Complexity: O(1)
+    For a large batch all pending adds are pushed down to the leaves in one top-down
+    pass, the leaves are written and the inner nodes are rebuilt once, instead of
+    walking the path to the root for every single update.
+*/
+void segment_tree_apply_batch(SegmentTree *st, const ArrayAssignment *assignments, int count) {
+    if (!batch_needs_rebuild(count, st->size)) {
+        for (int i = 0; i < count; i++) {
+            segment_tree_set(st, assignments[i].index, assignments[i].value);
+        }
+        return;
+    }
+
+    long long width = st->leaves / 2;
+    for (int level_start = 1; level_start < st->leaves; level_start <<= 1, width >>= 1) {
+        for (int p = level_start; p < 2 * level_start; p++) {
+            if (st->lazy[p] != 0) {
+                segment_tree_apply(st, 2 * p, st->lazy[p], width);
+                segment_tree_apply(st, 2 * p + 1, st->lazy[p], width);
+                st->lazy[p] = 0;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (assignments[i].index >= 0 && assignments[i].index < st->size) {
+            int p = assignments[i].index + st->leaves;
+            st->sum[p] = assignments[i].value;
+            st->min[p] = assignments[i].value;
+        }
+    }
+    segment_tree_build(st);
+}
+
 // main
 int main(int argc, char* argv[]) {
     // command line arguments
@@ -174,6 +613,36 @@ int main(int argc, char* argv[]) {
     delete_element(&arr, 2);
     display_array(arr);
 
+    FenwickTree ft = create_fenwick_tree(arr);
+    SegmentTree st = create_segment_tree(arr);
+    printf("\nSum of [1, 4]: Fenwick %lld, segment tree %lld\n",
+        fenwick_range_sum(&ft, 1, 4), segment_tree_range_sum(&st, 1, 4));
+    printf("Min of [1, 4]: %lld\n", segment_tree_range_min(&st, 1, 4));
+
+    fenwick_range_add(&ft, 0, 3, 10);
+    segment_tree_range_add(&st, 0, 3, 10);
+    printf("\nAfter adding 10 to [0, 3]:\n");
+    printf("Sum of [1, 4]: Fenwick %lld, segment tree %lld\n",
+        fenwick_range_sum(&ft, 1, 4), segment_tree_range_sum(&st, 1, 4));
+    printf("Min of [1, 4]: %lld\n", segment_tree_range_min(&st, 1, 4));
+
+    // the Fenwick batch adds deltas, the segment tree batch sets new values
+    ArrayDelta deltas[] = { { 0, -5 }, { 5, 100 } };
+    ArrayAssignment assignments[2];
+    for (int i = 0; i < 2; i++) {
+        assignments[i].index = deltas[i].index;
+        assignments[i].value = (int)segment_tree_range_sum(&st, deltas[i].index, deltas[i].index) + deltas[i].delta;
+    }
+    fenwick_apply_batch(&ft, deltas, 2);
+    segment_tree_apply_batch(&st, assignments, 2);
+    printf("\nAfter batch update (Fenwick adds deltas, segment tree sets the same results):\n");
+    printf("Sum of [0, 5]: Fenwick %lld, segment tree %lld\n",
+        fenwick_range_sum(&ft, 0, 5), segment_tree_range_sum(&st, 0, 5));
+    printf("Min of [0, 5]: %lld\n", segment_tree_range_min(&st, 0, 5));
+
+    free_fenwick_tree(&ft);
+    free_segment_tree(&st);
+
     free(arr.data); // free - deallocate memory that was previously allocated
     return 0;
 }
@@ -0,0 +1,1556 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_THREADS 64 // most threads a traversal uses
+#define CACHE_LINE_SIZE 64 // bytes, used to keep the counters of different threads apart
+#define BFS_ALPHA 14 // switch to bottom-up once the frontier has more than 1/ALPHA of the unexplored edges
+#define BFS_BETA 24 // switch back to top-down once the frontier has fewer than 1/BETA of the vertices
+#define BFS_QUEUE_CHUNK 64 // frontier vertices a thread claims at a time in a top-down step
+#define BFS_VERTEX_CHUNK 4096 // vertices a thread claims at a time in a bottom-up step (multiple of 64)
+#define INGEST_PARTITIONS_PER_THREAD 8 // vertex ranges per thread when building CSR, balances skewed degrees
+#define CSR_FILE_MAGIC "CSRGRPH2" // first 8 bytes of a binary CSR file
+#define CSR_FILE_UNDIRECTED 1 // flag: every edge of the edge list was added in both directions
+#define CSR_FILE_RELABELED 2 // flag: vertices were relabeled, the file ends with the new ids
+
+// helper to read a monotonic clock in nanoseconds
+static inline long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+compressed sparse row graph class (immutable)
+
+A linked list of neighbor nodes per vertex puts every edge in its own allocation, so a
+traversal jumps around memory and waits on a cache miss per edge. CSR stores all edges in
+one array, grouped by source vertex:
+    neighbors[offsets[v]] ... neighbors[offsets[v + 1] - 1] are the neighbors of v
+so the neighbors of a vertex are contiguous and a traversal streams through memory.
+The graph can't change after it is built, which is what keeps the layout this compact.
+*/
+typedef struct CsrGraph {
+    int num_vertices;
+    long num_edges; // directed edges, an undirected edge is stored in both directions
+    long *offsets; // num_vertices + 1 entries
+    int *neighbors; // num_edges entries
+    int *new_ids; // new id of every original vertex id after relabel_by_degree, NULL if the ids are the original ones
+    void *mapping; // set when the arrays live in a mapped CSR file instead of the heap
+    size_t mapping_size;
+} CsrGraph;
+
+// method to return the number of neighbors of vertex v, O(1)
+static inline long degree(const CsrGraph *graph, int v) {
+    return graph->offsets[v + 1] - graph->offsets[v];
+}
+
+/*
+method to build CSR graph from an edge list
+
+Create CSR graph:
+    Time Complexity: O(n + m)
+    Space Complexity: O(n + m)
+    Counting sort by source vertex: count the degree of every vertex, turn the counts
+    into offsets with a prefix sum, then place every edge at the next free slot of its
+    source. With undirected set every edge is also added in reverse.
+*/
+CsrGraph create_csr_graph(int num_vertices, const int *sources, const int *targets, long count, bool undirected) {
+    CsrGraph graph;
+    graph.num_vertices = num_vertices;
+    graph.num_edges = undirected ? 2 * count : count;
+    graph.offsets = (long*)calloc((size_t)num_vertices + 1, sizeof(long));
+    graph.neighbors = (int*)malloc(graph.num_edges * sizeof(int));
+    graph.new_ids = NULL;
+    graph.mapping = NULL;
+    graph.mapping_size = 0;
+
+    for (long i = 0; i < count; i++) {
+        graph.offsets[sources[i] + 1]++;
+        if (undirected) {
+            graph.offsets[targets[i] + 1]++;
+        }
+    }
+    for (int v = 0; v < num_vertices; v++) {
+        graph.offsets[v + 1] += graph.offsets[v];
+    }
+
+    long *next = (long*)malloc(num_vertices * sizeof(long)); // next free slot per vertex
+    memcpy(next, graph.offsets, num_vertices * sizeof(long));
+    for (long i = 0; i < count; i++) {
+        graph.neighbors[next[sources[i]]++] = targets[i];
+        if (undirected) {
+            graph.neighbors[next[targets[i]]++] = sources[i];
+        }
+    }
+    free(next);
+    return graph;
+}
+
+// method to free CSR graph
+void free_csr_graph(CsrGraph *graph) {
+    if (graph->mapping != NULL) {
+        munmap(graph->mapping, graph->mapping_size);
+    }
+    else {
+        free(graph->offsets);
+        free(graph->neighbors);
+        free(graph->new_ids);
+    }
+    graph->new_ids = NULL;
+    graph->mapping = NULL;
+    graph->mapping_size = 0;
+    graph->offsets = NULL;
+    graph->neighbors = NULL;
+    graph->num_vertices = 0;
+    graph->num_edges = 0;
+}
+
+// method to display the adjacency of every vertex
+void display_graph(const CsrGraph *graph) {
+    printf("\nGraph (%d vertices, %ld edges):\n", graph->num_vertices, graph->num_edges);
+    for (int v = 0; v < graph->num_vertices; v++) {
+        printf("\t%d ->", v);
+        for (long e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+            printf(" %d", graph->neighbors[e]);
+        }
+        printf("\n");
+    }
+}
+
+/*
+direction-optimizing breadth-first search (Beamer, Asanovic and Patterson, SC 2012)
+
+top-down step: every frontier vertex looks at its neighbors and claims the unvisited
+               ones. Cheap while the frontier is small.
+bottom-up step: every unvisited vertex looks for a neighbor in the frontier and stops at
+               the first one. Once the frontier is a large part of the graph most edges
+               of a top-down step only find vertices that are already visited, while
+               bottom-up usually finds a parent after checking a few neighbors.
+The search starts top-down, switches to bottom-up when the edges out of the frontier are
+more than 1/BFS_ALPHA of the edges not yet explored, and switches back when the frontier
+shrinks below 1/BFS_BETA of the vertices.
+
+Top-down keeps the frontier as a list of vertices. Threads claim chunks of it and collect
+the vertices they discover in their own buffer, so there is no shared queue to contend
+on, and the buffers are concatenated into the next frontier after the step. Bottom-up
+keeps the frontier as a bitmap (one bit per vertex, 64 per word) that is cheap to test.
+Threads claim ranges of vertices that start on a word boundary, so every thread writes
+only its own words of the next bitmap and needs no atomic operations.
+
+The worker threads are started once per search and wait on a barrier between levels,
+so a level only costs two barrier waits, not a thread start and join per thread. That
+matters for graphs with many levels and small frontiers.
+*/
+typedef struct BfsThread {
+    _Alignas(CACHE_LINE_SIZE) struct BfsShared *shared; // every thread's counters get their own cache line
+    int *buffer; // vertices discovered by this thread in a top-down step
+    long buffer_len;
+    long buffer_capacity;
+    long scout_count; // edges out of the discovered vertices
+    long awake_count; // vertices discovered in a bottom-up step
+} BfsThread;
+
+_Static_assert(sizeof(BfsThread) % CACHE_LINE_SIZE == 0, "BfsThread records must not share cache lines");
+
+typedef struct BfsShared {
+    const CsrGraph *graph;
+    atomic_int *parent; // parent of every vertex, -1 if not reached yet
+    int *queue; // top-down frontier
+    long queue_len;
+    uint64_t *front; // bottom-up frontier bitmap
+    uint64_t *next; // bottom-up next frontier bitmap
+    atomic_long next_chunk; // work distribution counter of the current step
+    atomic_bool failed; // a thread ran out of memory for its buffer
+    void *(*step)(void*); // step of the current level, NULL tells the workers to exit
+    pthread_mutex_t startup; // held while the workers are created, see parallel_bfs
+    pthread_barrier_t barrier; // before and after every step
+    int thread_count;
+    BfsThread threads[MAX_THREADS];
+} BfsShared;
+
+static inline bool bitmap_get(const uint64_t *bitmap, int v) {
+    return (bitmap[v >> 6] >> (v & 63)) & 1;
+}
+
+static inline void bitmap_set(uint64_t *bitmap, int v) {
+    bitmap[v >> 6] |= 1ULL << (v & 63);
+}
+
+// helper to append a vertex to a thread's buffer, doubling it when full, returns false if out of memory
+static bool bfs_buffer_push(BfsThread *thread, int v) {
+    if (thread->buffer_len == thread->buffer_capacity) {
+        long capacity = thread->buffer_capacity ? 2 * thread->buffer_capacity : 1024;
+        int *buffer = (int*)realloc(thread->buffer, capacity * sizeof(int));
+        if (buffer == NULL) {
+            return false; // the old buffer is still valid and gets freed with the others
+        }
+        thread->buffer = buffer;
+        thread->buffer_capacity = capacity;
+    }
+    thread->buffer[thread->buffer_len++] = v;
+    return true;
+}
+
+static void *bfs_top_down_thread(void *arg) {
+    BfsThread *thread = (BfsThread*)arg;
+    BfsShared *shared = thread->shared;
+    const CsrGraph *graph = shared->graph;
+
+    thread->buffer_len = 0;
+    thread->scout_count = 0;
+
+    for (;;) {
+        long begin = atomic_fetch_add_explicit(&shared->next_chunk, BFS_QUEUE_CHUNK, memory_order_relaxed);
+        if (begin >= shared->queue_len) {
+            break;
+        }
+        long end = begin + BFS_QUEUE_CHUNK < shared->queue_len ? begin + BFS_QUEUE_CHUNK : shared->queue_len;
+
+        for (long i = begin; i < end; i++) {
+            int u = shared->queue[i];
+            for (long e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+                int v = graph->neighbors[e];
+                int unvisited = -1;
+
+                // the plain load filters most visited vertices without a locked instruction
+                if (atomic_load_explicit(&shared->parent[v], memory_order_relaxed) == -1 &&
+                        atomic_compare_exchange_strong_explicit(&shared->parent[v], &unvisited, u,
+                            memory_order_relaxed, memory_order_relaxed)) {
+                    if (!bfs_buffer_push(thread, v)) {
+                        atomic_store(&shared->failed, true);
+                        return NULL;
+                    }
+                    thread->scout_count += degree(graph, v);
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+static void *bfs_bottom_up_thread(void *arg) {
+    BfsThread *thread = (BfsThread*)arg;
+    BfsShared *shared = thread->shared;
+    const CsrGraph *graph = shared->graph;
+    int n = graph->num_vertices;
+
+    thread->awake_count = 0;
+
+    for (;;) {
+        long begin = atomic_fetch_add_explicit(&shared->next_chunk, BFS_VERTEX_CHUNK, memory_order_relaxed);
+        if (begin >= n) {
+            break;
+        }
+        long end = begin + BFS_VERTEX_CHUNK < n ? begin + BFS_VERTEX_CHUNK : n;
+
+        // this range owns its words of next, clear them before use
+        memset(shared->next + (begin >> 6), 0, ((end - begin + 63) >> 6) * sizeof(uint64_t));
+
+        for (int v = (int)begin; v < end; v++) {
+            if (atomic_load_explicit(&shared->parent[v], memory_order_relaxed) != -1) {
+                continue;
+            }
+            for (long e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+                int u = graph->neighbors[e];
+                if (bitmap_get(shared->front, u)) {
+                    atomic_store_explicit(&shared->parent[v], u, memory_order_relaxed);
+                    bitmap_set(shared->next, v);
+                    thread->awake_count++;
+                    break; // one parent is enough, skip the remaining edges
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+// worker loop: wait for a step, run it, wait for the others to finish it
+static void *bfs_worker(void *arg) {
+    BfsThread *thread = (BfsThread*)arg;
+    BfsShared *shared = thread->shared;
+
+    // the barrier is set up once every worker has been created
+    pthread_mutex_lock(&shared->startup);
+    pthread_mutex_unlock(&shared->startup);
+
+    for (;;) {
+        pthread_barrier_wait(&shared->barrier);
+        if (shared->step == NULL) {
+            return NULL;
+        }
+        shared->step(thread);
+        pthread_barrier_wait(&shared->barrier);
+    }
+}
+
+// helper to run one step on every thread, the calling thread works as thread 0
+static void bfs_run_step(BfsShared *shared, void *(*step)(void*)) {
+    atomic_store(&shared->next_chunk, 0);
+    shared->step = step;
+    pthread_barrier_wait(&shared->barrier); // workers start the step
+    step(&shared->threads[0]);
+    pthread_barrier_wait(&shared->barrier); // every worker is done with the step
+}
+
+// helper to gather the per-thread buffers into the next frontier, returns the scout count
+static long bfs_gather_queue(BfsShared *shared) {
+    long length = 0;
+    long scout_count = 0;
+
+    for (int i = 0; i < shared->thread_count; i++) {
+        BfsThread *thread = &shared->threads[i];
+        if (thread->buffer_len > 0) {
+            memcpy(shared->queue + length, thread->buffer, thread->buffer_len * sizeof(int));
+        }
+        length += thread->buffer_len;
+        scout_count += thread->scout_count;
+    }
+    shared->queue_len = length;
+    return scout_count;
+}
+
+/*
+method to run breadth-first search from root
+
+Parallel BFS:
+    Time Complexity: O(n + m) work, split over thread_count threads
+    Space Complexity: O(n)
+    parent must have room for every vertex. Afterwards parent[v] is the vertex v was
+    reached from (parent[root] == root) or -1 if v is not reachable.
+    Returns the number of reached vertices, or -1 if memory ran out (parent is then
+    incomplete). If fewer threads can be started the search runs with those.
+*/
+long parallel_bfs(const CsrGraph *graph, int root, atomic_int *parent, int thread_count) {
+    int n = graph->num_vertices;
+    long words = ((long)n + 63) / 64;
+    BfsShared *shared = (BfsShared*)aligned_alloc(CACHE_LINE_SIZE, sizeof(BfsShared));
+    if (shared == NULL) {
+        return -1;
+    }
+    memset(shared, 0, sizeof(BfsShared));
+
+    shared->graph = graph;
+    shared->parent = parent;
+    shared->queue = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    shared->front = (uint64_t*)calloc(words + 1, sizeof(uint64_t));
+    shared->next = (uint64_t*)calloc(words + 1, sizeof(uint64_t));
+    if (shared->queue == NULL || shared->front == NULL || shared->next == NULL) {
+        free(shared->queue);
+        free(shared->front);
+        free(shared->next);
+        free(shared);
+        return -1;
+    }
+
+    /*
+    start the workers once for the whole search
+    the barrier needs the final thread count, so the workers wait on startup until it
+    is known, which also lets the search go on with fewer threads if a create fails
+    */
+    thread_count = thread_count < 1 ? 1 : thread_count > MAX_THREADS ? MAX_THREADS : thread_count;
+    pthread_t workers[MAX_THREADS];
+    pthread_mutex_init(&shared->startup, NULL);
+    pthread_mutex_lock(&shared->startup);
+    shared->thread_count = 1;
+    shared->threads[0].shared = shared;
+    for (int i = 1; i < thread_count; i++) {
+        shared->threads[i].shared = shared;
+        if (pthread_create(&workers[i], NULL, bfs_worker, &shared->threads[i]) != 0) {
+            break;
+        }
+        shared->thread_count++;
+    }
+    pthread_barrier_init(&shared->barrier, NULL, shared->thread_count);
+    pthread_mutex_unlock(&shared->startup);
+
+    for (int v = 0; v < n; v++) {
+        atomic_init(&parent[v], -1);
+    }
+    atomic_store(&parent[root], root);
+    shared->queue[0] = root;
+    shared->queue_len = 1;
+
+    long reached = 1;
+    long edges_to_check = graph->num_edges;
+    long scout_count = degree(graph, root);
+
+    while (shared->queue_len > 0) {
+        if (scout_count > edges_to_check / BFS_ALPHA) {
+            // frontier list -> bitmap
+            memset(shared->front, 0, words * sizeof(uint64_t));
+            for (long i = 0; i < shared->queue_len; i++) {
+                bitmap_set(shared->front, shared->queue[i]);
+            }
+
+            long awake_count = shared->queue_len;
+            long old_awake_count;
+            do {
+                old_awake_count = awake_count;
+                bfs_run_step(shared, bfs_bottom_up_thread);
+
+                awake_count = 0;
+                for (int i = 0; i < shared->thread_count; i++) {
+                    awake_count += shared->threads[i].awake_count;
+                }
+                reached += awake_count;
+
+                uint64_t *swap = shared->front;
+                shared->front = shared->next;
+                shared->next = swap;
+            } while (awake_count > 0 && (awake_count >= old_awake_count || awake_count > n / BFS_BETA));
+
+            // bitmap -> frontier list
+            shared->queue_len = 0;
+            for (long w = 0; w < words; w++) {
+                for (uint64_t bits = shared->front[w]; bits != 0; bits &= bits - 1) {
+                    shared->queue[shared->queue_len++] = (int)(w * 64 + __builtin_ctzll(bits));
+                }
+            }
+            scout_count = 1;
+        }
+        else {
+            edges_to_check -= scout_count;
+            bfs_run_step(shared, bfs_top_down_thread);
+            if (atomic_load(&shared->failed)) {
+                reached = -1;
+                break;
+            }
+            scout_count = bfs_gather_queue(shared);
+            reached += shared->queue_len;
+        }
+    }
+
+    // release the workers from their barrier wait with no step, they exit
+    shared->step = NULL;
+    pthread_barrier_wait(&shared->barrier);
+    for (int i = 1; i < shared->thread_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    pthread_barrier_destroy(&shared->barrier);
+    pthread_mutex_destroy(&shared->startup);
+
+    for (int i = 0; i < shared->thread_count; i++) {
+        free(shared->threads[i].buffer);
+    }
+    free(shared->queue);
+    free(shared->front);
+    free(shared->next);
+    free(shared);
+    return reached;
+}
+
+/*
+RMAT graph generator (Chakrabarti, Zhan and Faloutsos, SDM 2004)
+
+Every edge picks its source and target bit by bit by recursively choosing one of the
+four quadrants of the adjacency matrix with probabilities a, b, c and d. The skewed
+probabilities give a power-law degree distribution like social and web graphs.
+The Graph500 parameters are used: a = 0.57, b = 0.19, c = 0.19, d = 0.05.
+*/
+static uint64_t rmat_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+void generate_rmat_edges(int scale, long count, int *sources, int *targets, uint64_t seed) {
+    uint64_t state = seed | 1;
+
+    for (long i = 0; i < count; i++) {
+        int source = 0;
+        int target = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            double r = (double)(rmat_random(&state) >> 11) / (double)(1ULL << 53);
+            if (r < 0.57) {
+                // top left quadrant, no bits set
+            }
+            else if (r < 0.76) {
+                target |= 1 << bit;
+            }
+            else if (r < 0.95) {
+                source |= 1 << bit;
+            }
+            else {
+                source |= 1 << bit;
+                target |= 1 << bit;
+            }
+        }
+        sources[i] = source;
+        targets[i] = target;
+    }
+}
+
+/*
+edge list ingestion
+
+Reads a text edge list, one "source target" pair of vertex ids per line. Anything after
+the target (weights, timestamps) is ignored, and lines starting with '#' or '%' are
+comments (SNAP and Matrix Market headers).
+The file is mapped instead of read, so the kernel pages it in while the threads parse and
+nothing is copied into a buffer first. The file is cut into one chunk per thread at line
+boundaries, and the CSR arrays are built in phases separated by a barrier:
+    1. parse: every thread parses its chunk into its own edge buffer
+    2. count: the vertices are split into ranges (partitions), every thread counts how
+             many of its edges start in each partition
+    3. prefix sum over the (partition, thread) counts, a small table
+    4. partition: every thread copies its edges into its slots of their partitions
+    5. build: threads claim partitions one at a time and, for the vertices of that range
+             only, count the degrees in offsets, scan them starting at the first edge of
+             the partition (known from step 3) and scatter the neighbors
+Every partition is built by one thread, so the degree counters are simply offsets
+itself and need no atomic operations and no extra memory per thread, only the O(m)
+partitioned copy of the edges. Partitions are small and claimed dynamically, so the
+hubs of a skewed graph don't leave one thread with most of the work. The edges of every
+vertex keep the order of the file, so the result is the same for any number of threads.
+*/
+typedef struct IngestThread {
+    struct IngestShared *shared;
+    int id;
+    const char *begin; // the lines this thread parses
+    const char *end;
+    int *edges; // parsed (source, target) pairs
+    long edge_count;
+    long edge_capacity;
+    int max_vertex;
+    bool invalid; // a line this thread parsed is not an edge
+    bool out_of_memory; // the edge buffer of this thread couldn't grow
+} IngestThread;
+
+typedef struct IngestShared {
+    bool undirected;
+    bool failed;
+    int thread_count;
+    pthread_mutex_t startup; // held while the threads are created, see load_edge_list
+    pthread_barrier_t barrier;
+    CsrGraph graph;
+    int partition_count;
+    int partition_size; // vertices per partition
+    long *slots; // next slot of thread t in partition p at [p * thread_count + t]
+    int *partitioned; // (source, target) pairs grouped by the partition of source
+    atomic_int next_partition; // partition to build next
+    IngestThread threads[MAX_THREADS];
+} IngestShared;
+
+static inline bool is_digit(char c) {
+    return (unsigned)(c - '0') <= 9;
+}
+
+// helper to parse a vertex id at *text, fails when there are no digits or the id is INT_MAX or more
+// (the vertex count, largest id + 1, has to fit in an int too)
+static inline bool parse_vertex(const char **text, const char *end, int *vertex) {
+    const char *p = *text;
+    long value = 0;
+
+    if (p == end || !is_digit(*p)) {
+        return false;
+    }
+    do {
+        value = value * 10 + (*p++ - '0');
+        if (value >= INT_MAX) {
+            return false;
+        }
+    } while (p != end && is_digit(*p));
+
+    *text = p;
+    *vertex = (int)value;
+    return true;
+}
+
+// helper to move past the end of the current line
+static inline const char *next_line(const char *p, const char *end) {
+    const char *newline = (const char*)memchr(p, '\n', end - p);
+    return newline != NULL ? newline + 1 : end;
+}
+
+static void ingest_parse(IngestThread *thread) {
+    const char *p = thread->begin;
+    const char *end = thread->end;
+
+    thread->max_vertex = -1;
+    thread->edge_capacity = (end - p) / 8 + 64; // a short line is about 8 bytes
+    thread->edges = (int*)malloc(2 * thread->edge_capacity * sizeof(int));
+    if (thread->edges == NULL) {
+        thread->out_of_memory = true;
+        return;
+    }
+
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            p++;
+        }
+        if (p == end) {
+            break;
+        }
+        if (*p == '\n' || *p == '#' || *p == '%') {
+            p = next_line(p, end);
+            continue;
+        }
+
+        int source;
+        int target;
+        if (!parse_vertex(&p, end, &source)) {
+            thread->invalid = true;
+            return;
+        }
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ',')) {
+            p++;
+        }
+        if (!parse_vertex(&p, end, &target)) {
+            thread->invalid = true;
+            return;
+        }
+        p = next_line(p, end);
+
+        if (thread->edge_count == thread->edge_capacity) {
+            // keep the old buffer on failure, load_edge_list frees it
+            int *grown = (int*)realloc(thread->edges, 4 * thread->edge_capacity * sizeof(int));
+            if (grown == NULL) {
+                thread->out_of_memory = true;
+                return;
+            }
+            thread->edges = grown;
+            thread->edge_capacity *= 2;
+        }
+        thread->edges[2 * thread->edge_count] = source;
+        thread->edges[2 * thread->edge_count + 1] = target;
+        thread->edge_count++;
+
+        int larger = source > target ? source : target;
+        if (larger > thread->max_vertex) {
+            thread->max_vertex = larger;
+        }
+    }
+}
+
+// helper run by thread 0 between parse and count, sizes and allocates the graph
+static void ingest_allocate(IngestShared *shared) {
+    int max_vertex = -1;
+    long count = 0;
+
+    for (int i = 0; i < shared->thread_count; i++) {
+        IngestThread *thread = &shared->threads[i];
+        if (thread->invalid || thread->out_of_memory) {
+            shared->failed = true;
+            return;
+        }
+        if (thread->max_vertex > max_vertex) {
+            max_vertex = thread->max_vertex;
+        }
+        count += thread->edge_count;
+    }
+
+    shared->graph.num_vertices = max_vertex + 1;
+    shared->graph.num_edges = shared->undirected ? 2 * count : count;
+    shared->graph.offsets = (long*)calloc((size_t)shared->graph.num_vertices + 1, sizeof(long));
+    shared->graph.neighbors = (int*)malloc((shared->graph.num_edges + 1) * sizeof(int));
+
+    int n = shared->graph.num_vertices;
+    int partitions = shared->thread_count * INGEST_PARTITIONS_PER_THREAD;
+    shared->partition_size = n / partitions + 1;
+    shared->partition_count = n / shared->partition_size + 1;
+    shared->slots = (long*)calloc((long)shared->partition_count * shared->thread_count + 1, sizeof(long));
+    shared->partitioned = (int*)malloc((2 * shared->graph.num_edges + 1) * sizeof(int));
+    atomic_init(&shared->next_partition, 0);
+
+    if (shared->graph.offsets == NULL || shared->graph.neighbors == NULL ||
+            shared->slots == NULL || shared->partitioned == NULL) {
+        shared->failed = true;
+    }
+}
+
+// helper to copy an edge into the next slot of this thread in the partition of source
+static inline void ingest_partition_edge(IngestShared *shared, int id, int source, int target) {
+    long slot = shared->slots[(long)(source / shared->partition_size) * shared->thread_count + id]++;
+    shared->partitioned[2 * slot] = source;
+    shared->partitioned[2 * slot + 1] = target;
+}
+
+static void *ingest_thread(void *arg) {
+    IngestThread *thread = (IngestThread*)arg;
+    IngestShared *shared = thread->shared;
+    CsrGraph *graph = &shared->graph;
+
+    // wait until the chunks and the barrier are set up for the threads that started
+    pthread_mutex_lock(&shared->startup);
+    pthread_mutex_unlock(&shared->startup);
+
+    // 1. parse
+    ingest_parse(thread);
+    pthread_barrier_wait(&shared->barrier);
+    if (thread->id == 0) {
+        ingest_allocate(shared);
+    }
+    pthread_barrier_wait(&shared->barrier);
+    if (shared->failed) {
+        return NULL;
+    }
+
+    // 2. count
+    int n = graph->num_vertices;
+    int id = thread->id;
+    int threads = shared->thread_count;
+    int size = shared->partition_size;
+    long *slots = shared->slots;
+    const int *edges = thread->edges;
+    for (long i = 0; i < thread->edge_count; i++) {
+        slots[(long)(edges[2 * i] / size) * threads + id]++;
+        if (shared->undirected) {
+            slots[(long)(edges[2 * i + 1] / size) * threads + id]++;
+        }
+    }
+    pthread_barrier_wait(&shared->barrier);
+
+    // 3. prefix sum, partition by partition and within a partition thread by thread
+    if (id == 0) {
+        long sum = 0;
+        for (long i = 0; i < (long)shared->partition_count * threads; i++) {
+            long count = slots[i];
+            slots[i] = sum;
+            sum += count;
+        }
+    }
+    pthread_barrier_wait(&shared->barrier);
+
+    // 4. partition
+    for (long i = 0; i < thread->edge_count; i++) {
+        ingest_partition_edge(shared, id, edges[2 * i], edges[2 * i + 1]);
+        if (shared->undirected) {
+            ingest_partition_edge(shared, id, edges[2 * i + 1], edges[2 * i]);
+        }
+    }
+    free(thread->edges); // everything is in the partitions now
+    thread->edges = NULL;
+    pthread_barrier_wait(&shared->barrier);
+
+    // 5. build, a slot now points past its run, so partition p spans the runs of (p - 1, last thread) to (p, last thread)
+    long *offsets = graph->offsets;
+    const int *partitioned = shared->partitioned;
+    for (;;) {
+        int p = atomic_fetch_add_explicit(&shared->next_partition, 1, memory_order_relaxed);
+        if (p >= shared->partition_count) {
+            break;
+        }
+        int low = p * size;
+        int high = (long)low + size < n ? low + size : n;
+        long begin = p == 0 ? 0 : slots[(long)p * threads - 1];
+        long end = slots[(long)p * threads + threads - 1];
+
+        // offsets[v + 1] counts the degree of v, then holds the next free slot of v and ends as the end of v
+        for (long e = begin; e < end; e++) {
+            offsets[partitioned[2 * e] + 1]++;
+        }
+        long next = begin;
+        for (int v = low; v < high; v++) {
+            long count = offsets[v + 1];
+            offsets[v + 1] = next;
+            next += count;
+        }
+        for (long e = begin; e < end; e++) {
+            graph->neighbors[offsets[partitioned[2 * e] + 1]++] = partitioned[2 * e + 1];
+        }
+    }
+    return NULL;
+}
+
+/*
+method to load a CSR graph from a text edge list
+
+Load edge list:
+    Time Complexity: O(file size + n + m) work, split over thread_count threads
+    Space Complexity: O(n + m)
+    The number of vertices is the largest id + 1. With undirected set every edge is
+    also added in reverse. Returns false if the file can't be read, a line is not
+    an edge or memory runs out.
+*/
+bool load_edge_list(const char *path, bool undirected, int thread_count, CsrGraph *graph) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("\nCan't open %s.", path);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        printf("\nCan't read %s.", path);
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)info.st_size;
+    const char *data = "";
+    if (size > 0) {
+        data = (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            printf("\nCan't map %s.", path);
+            close(fd);
+            return false;
+        }
+        madvise((void*)data, size, MADV_SEQUENTIAL);
+    }
+    close(fd); // the mapping stays valid
+
+    IngestShared *shared = (IngestShared*)calloc(1, sizeof(IngestShared));
+    if (shared == NULL) {
+        printf("\nNot enough memory to load %s.", path);
+        if (size > 0) {
+            munmap((void*)data, size);
+        }
+        return false;
+    }
+    shared->undirected = undirected;
+    thread_count = thread_count < 1 ? 1 : thread_count > MAX_THREADS ? MAX_THREADS : thread_count;
+
+    // as in parallel_bfs the threads wait on startup, so chunks and barrier fit the threads that started
+    pthread_t threads[MAX_THREADS];
+    pthread_mutex_init(&shared->startup, NULL);
+    pthread_mutex_lock(&shared->startup);
+    shared->thread_count = 1;
+    shared->threads[0].shared = shared;
+    for (int i = 1; i < thread_count; i++) {
+        shared->threads[i].shared = shared;
+        shared->threads[i].id = i;
+        if (pthread_create(&threads[i], NULL, ingest_thread, &shared->threads[i]) != 0) {
+            break;
+        }
+        shared->thread_count++;
+    }
+
+    // chunk boundaries move forward to the start of the next line
+    size_t boundary = 0;
+    for (int i = 0; i < shared->thread_count; i++) {
+        IngestThread *thread = &shared->threads[i];
+        size_t chunk_end = size * (i + 1) / shared->thread_count;
+        if (chunk_end < boundary) {
+            chunk_end = boundary;
+        }
+        if (chunk_end > 0 && chunk_end < size && data[chunk_end - 1] != '\n') {
+            chunk_end = next_line(data + chunk_end, data + size) - data;
+        }
+
+        thread->begin = data + boundary;
+        thread->end = data + chunk_end;
+        boundary = chunk_end;
+    }
+
+    pthread_barrier_init(&shared->barrier, NULL, shared->thread_count);
+    pthread_mutex_unlock(&shared->startup);
+    ingest_thread(&shared->threads[0]);
+    for (int i = 1; i < shared->thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&shared->barrier);
+    pthread_mutex_destroy(&shared->startup);
+
+    bool invalid = false;
+    for (int i = 0; i < shared->thread_count; i++) {
+        invalid = invalid || shared->threads[i].invalid;
+        free(shared->threads[i].edges);
+    }
+    if (size > 0) {
+        munmap((void*)data, size);
+    }
+
+    bool loaded = !shared->failed;
+    if (loaded) {
+        *graph = shared->graph;
+    }
+    else {
+        printf(invalid ? "\nInvalid edge list %s." : "\nNot enough memory to load %s.", path);
+        free(shared->graph.offsets);
+        free(shared->graph.neighbors);
+    }
+    free(shared->slots);
+    free(shared->partitioned);
+    free(shared);
+    return loaded;
+}
+
+/*
+degree-based relabeling
+
+Renumbers the vertices by decreasing degree and sorts every neighbor list. The hubs of a
+power-law graph end up next to each other at the front of every array, so the few
+vertices that most edges point at share cache lines, and because every neighbor list
+starts with its highest-degree neighbors a bottom-up BFS step finds a parent in the
+frontier sooner.
+*/
+typedef struct VertexDegree {
+    long degree;
+    int vertex;
+} VertexDegree;
+
+typedef struct RelabelThread {
+    const CsrGraph *graph;
+    CsrGraph *relabeled;
+    const int *order; // old id of every new id
+    const int *new_ids; // new id of every old id
+    int begin; // new ids this thread fills
+    int end;
+} RelabelThread;
+
+static int compare_vertex_degree(const void *a, const void *b) {
+    const VertexDegree *x = (const VertexDegree*)a;
+    const VertexDegree *y = (const VertexDegree*)b;
+    if (x->degree != y->degree) {
+        return x->degree > y->degree ? -1 : 1;
+    }
+    return x->vertex - y->vertex;
+}
+
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static void *relabel_thread(void *arg) {
+    RelabelThread *work = (RelabelThread*)arg;
+    const CsrGraph *graph = work->graph;
+    CsrGraph *relabeled = work->relabeled;
+
+    for (int v = work->begin; v < work->end; v++) {
+        int old = work->order[v];
+        int *list = relabeled->neighbors + relabeled->offsets[v];
+        long length = degree(graph, old);
+
+        for (long i = 0; i < length; i++) {
+            list[i] = work->new_ids[graph->neighbors[graph->offsets[old] + i]];
+        }
+        qsort(list, length, sizeof(int), compare_int);
+    }
+    return NULL;
+}
+
+/*
+method to relabel a graph by decreasing degree
+
+Relabel by degree:
+    Time Complexity: O(n log n + m log d) with d the largest degree
+    Space Complexity: O(n + m)
+    Fills *result with a new graph, the original is left alone. The new graph's new_ids
+    maps every original vertex id to its new id (through earlier relabelings too), so
+    callers can translate their own ids, e.g. BFS roots. Returns false if memory runs out.
+*/
+bool relabel_by_degree(const CsrGraph *graph, int thread_count, CsrGraph *result) {
+    int n = graph->num_vertices;
+    VertexDegree *ranking = (VertexDegree*)malloc(((size_t)n + 1) * sizeof(VertexDegree));
+    int *order = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    int *ids = (int*)malloc(((size_t)n + 1) * sizeof(int)); // new id of every id of graph
+    int *composed = graph->new_ids != NULL ? (int*)malloc(((size_t)n + 1) * sizeof(int)) : NULL;
+
+    CsrGraph relabeled;
+    relabeled.num_vertices = n;
+    relabeled.num_edges = graph->num_edges;
+    relabeled.offsets = (long*)malloc(((size_t)n + 1) * sizeof(long));
+    relabeled.neighbors = (int*)malloc((graph->num_edges + 1) * sizeof(int));
+    relabeled.new_ids = NULL;
+    relabeled.mapping = NULL;
+    relabeled.mapping_size = 0;
+
+    if (ranking == NULL || order == NULL || ids == NULL || (graph->new_ids != NULL && composed == NULL) ||
+            relabeled.offsets == NULL || relabeled.neighbors == NULL) {
+        free(ranking);
+        free(order);
+        free(ids);
+        free(composed);
+        free(relabeled.offsets);
+        free(relabeled.neighbors);
+        return false;
+    }
+
+    for (int v = 0; v < n; v++) {
+        ranking[v].degree = degree(graph, v);
+        ranking[v].vertex = v;
+    }
+    qsort(ranking, n, sizeof(VertexDegree), compare_vertex_degree);
+
+    relabeled.offsets[0] = 0;
+    for (int v = 0; v < n; v++) {
+        order[v] = ranking[v].vertex;
+        ids[ranking[v].vertex] = v;
+        relabeled.offsets[v + 1] = relabeled.offsets[v] + ranking[v].degree;
+    }
+    free(ranking);
+
+    // split by edges rather than vertices, the hubs at the front would leave the first thread most of the work
+    thread_count = thread_count < 1 ? 1 : thread_count > MAX_THREADS ? MAX_THREADS : thread_count;
+    RelabelThread work[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    int begin = 0;
+    for (int i = 0; i < thread_count; i++) {
+        long edge_end = graph->num_edges * (i + 1) / thread_count;
+        int end = begin;
+        while (end < n && (i == thread_count - 1 || relabeled.offsets[end] < edge_end)) {
+            end++;
+        }
+        work[i] = (RelabelThread){ graph, &relabeled, order, ids, begin, end };
+        begin = end;
+    }
+
+    // the ranges of threads that couldn't be created are done here
+    int started = 1;
+    while (started < thread_count && pthread_create(&threads[started], NULL, relabel_thread, &work[started]) == 0) {
+        started++;
+    }
+    relabel_thread(&work[0]);
+    for (int i = started; i < thread_count; i++) {
+        relabel_thread(&work[i]);
+    }
+    for (int i = 1; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    free(order);
+
+    // a graph that was relabeled before maps original ids through both permutations
+    if (composed != NULL) {
+        for (int v = 0; v < n; v++) {
+            composed[v] = ids[graph->new_ids[v]];
+        }
+        free(ids);
+        ids = composed;
+    }
+    relabeled.new_ids = ids;
+    *result = relabeled;
+    return true;
+}
+
+/*
+binary CSR file
+
+    header: magic, sizes, flags and the edge list it was built from (CsrFileHeader)
+    offsets: num_vertices + 1 longs
+    neighbors: num_edges ints
+    new ids: num_vertices ints, only with CSR_FILE_RELABELED
+The layout is the in-memory layout of CsrGraph, so a file can be mapped and used as the
+graph directly with no parsing and no copy. Files are meant for the machine that wrote
+them (same byte order and type sizes).
+The header records how the graph was built (CsrFileSource): the flags and the size and
+modification time (in nanoseconds) of the edge list. A cache is only reused when all of
+them match, so a cache built with other flags or from an older edge list, even one
+rewritten within the same second, is never served.
+*/
+typedef struct CsrFileHeader {
+    char magic[8];
+    int64_t num_vertices;
+    int64_t num_edges;
+    uint32_t flags; // CSR_FILE_UNDIRECTED, CSR_FILE_RELABELED
+    uint32_t reserved;
+    int64_t source_size; // size of the edge list in bytes
+    int64_t source_mtime_ns; // modification time of the edge list in nanoseconds
+} CsrFileHeader;
+
+// what a binary CSR file was built from
+typedef struct CsrFileSource {
+    bool undirected;
+    bool relabeled;
+    int64_t size; // size of the edge list in bytes, -1 if unknown
+    int64_t mtime_ns; // modification time of the edge list in nanoseconds
+} CsrFileSource;
+
+_Static_assert(sizeof(long) == sizeof(int64_t), "CSR files store offsets as 64-bit longs");
+
+// helper to describe an edge list, returns false if it can't be read
+static bool csr_file_source(const char *edge_path, bool undirected, bool relabeled, CsrFileSource *source) {
+    struct stat info;
+    source->undirected = undirected;
+    source->relabeled = relabeled;
+    source->size = -1;
+    source->mtime_ns = 0;
+    if (stat(edge_path, &info) != 0) {
+        return false;
+    }
+    source->size = (int64_t)info.st_size;
+    source->mtime_ns = (int64_t)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+    return true;
+}
+
+/*
+method to write a graph to a binary CSR file
+
+source describes the edge list the graph was built from, its relabeled flag must match
+graph->new_ids. The file is written to path.tmp and renamed, so readers never see half
+a file.
+*/
+bool save_csr_graph(const CsrGraph *graph, const CsrFileSource *source, const char *path) {
+    char temp_path[4096];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    FILE *file = fopen(temp_path, "wb");
+    if (file == NULL) {
+        printf("\nCan't create %s.", temp_path);
+        return false;
+    }
+
+    CsrFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CSR_FILE_MAGIC, sizeof(header.magic));
+    header.num_vertices = graph->num_vertices;
+    header.num_edges = graph->num_edges;
+    header.flags = (source->undirected ? CSR_FILE_UNDIRECTED : 0) | (graph->new_ids != NULL ? CSR_FILE_RELABELED : 0);
+    header.source_size = source->size;
+    header.source_mtime_ns = source->mtime_ns;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(graph->offsets, sizeof(long), (size_t)graph->num_vertices + 1, file) == (size_t)graph->num_vertices + 1 &&
+        fwrite(graph->neighbors, sizeof(int), graph->num_edges, file) == (size_t)graph->num_edges &&
+        (graph->new_ids == NULL ||
+            fwrite(graph->new_ids, sizeof(int), graph->num_vertices, file) == (size_t)graph->num_vertices);
+    written = fclose(file) == 0 && written;
+
+    if (!written || rename(temp_path, path) != 0) {
+        printf("\nCan't write %s.", path);
+        unlink(temp_path);
+        return false;
+    }
+    return true;
+}
+
+// helper to check that the arrays of a graph describe a graph, nothing is read out of bounds
+static bool csr_arrays_valid(const CsrGraph *graph) {
+    int n = graph->num_vertices;
+    if (graph->offsets[0] != 0 || graph->offsets[n] != graph->num_edges) {
+        return false;
+    }
+    for (int v = 0; v < n; v++) {
+        if (graph->offsets[v + 1] < graph->offsets[v]) {
+            return false;
+        }
+    }
+    for (long e = 0; e < graph->num_edges; e++) {
+        if ((unsigned)graph->neighbors[e] >= (unsigned)n) {
+            return false;
+        }
+    }
+    for (int v = 0; graph->new_ids != NULL && v < n; v++) {
+        if ((unsigned)graph->new_ids[v] >= (unsigned)n) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+method to map a binary CSR file as a graph, free_csr_graph unmaps it
+
+expected may be NULL to take any valid file. Otherwise the flags must match, and the
+edge list size and modification time too unless expected->size is -1 (edge list gone).
+The arrays are checked once before the graph is handed out (offsets start at 0, never
+decrease and end at num_edges, every id is a vertex), so a damaged file is turned down
+instead of sending a traversal out of bounds. That costs one read of the file.
+*/
+bool map_csr_graph(const char *path, const CsrFileSource *expected, CsrGraph *graph) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CsrFileHeader)) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)info.st_size;
+    char *data = (char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    // the counts are bounded by the file size first, so the size arithmetic can't overflow
+    CsrFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    bool relabeled = (header.flags & CSR_FILE_RELABELED) != 0;
+    bool valid = memcmp(header.magic, CSR_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+        header.num_vertices >= 0 && header.num_vertices <= INT_MAX &&
+        header.num_edges >= 0 && (uint64_t)header.num_edges <= size / sizeof(int) &&
+        size == sizeof(header) + ((size_t)header.num_vertices + 1) * sizeof(long) +
+            (size_t)header.num_edges * sizeof(int) + (relabeled ? (size_t)header.num_vertices * sizeof(int) : 0);
+
+    if (valid && expected != NULL) {
+        valid = ((header.flags & CSR_FILE_UNDIRECTED) != 0) == expected->undirected &&
+            relabeled == expected->relabeled &&
+            (expected->size < 0 ||
+                (header.source_size == expected->size && header.source_mtime_ns == expected->mtime_ns));
+    }
+    if (!valid) {
+        munmap(data, size);
+        return false;
+    }
+
+    char *arrays = data + sizeof(header);
+    CsrGraph mapped;
+    mapped.num_vertices = (int)header.num_vertices;
+    mapped.num_edges = header.num_edges;
+    mapped.offsets = (long*)arrays;
+    mapped.neighbors = (int*)(arrays + ((size_t)header.num_vertices + 1) * sizeof(long));
+    mapped.new_ids = relabeled ? mapped.neighbors + header.num_edges : NULL;
+    mapped.mapping = data;
+    mapped.mapping_size = size;
+    if (!csr_arrays_valid(&mapped)) {
+        munmap(data, size);
+        return false;
+    }
+    *graph = mapped;
+    return true;
+}
+
+/*
+method to load a graph through its binary cache
+
+Ingest graph:
+    Maps cache_path when it was built with the same flags from the edge list as it is
+    now (same size and modification time). Otherwise it loads the edge list, relabels it
+    by degree if asked to and writes the cache for the next run.
+    With relabel set, graph->new_ids gives the new id of every vertex id of the edge list.
+    Returns false only if the graph can't be loaded at all.
+*/
+bool ingest_graph(const char *edge_path, const char *cache_path, bool undirected, bool relabel, int thread_count, CsrGraph *graph) {
+    CsrFileSource source;
+    csr_file_source(edge_path, undirected, relabel, &source); // size -1 if the edge list is gone
+
+    if (map_csr_graph(cache_path, &source, graph)) {
+        return true;
+    }
+
+    if (!load_edge_list(edge_path, undirected, thread_count, graph)) {
+        return false;
+    }
+    if (relabel) {
+        CsrGraph relabeled;
+        bool done = relabel_by_degree(graph, thread_count, &relabeled);
+        free_csr_graph(graph);
+        if (!done) {
+            printf("\nNot enough memory to relabel %s.", edge_path);
+            return false;
+        }
+        *graph = relabeled;
+    }
+    save_csr_graph(graph, &source, cache_path); // without a cache the next run parses again, the graph is still good
+    return true;
+}
+
+// helper to check that every reached vertex has a reached neighbor as its parent
+static bool bfs_check_parents(const CsrGraph *graph, int root, atomic_int *parent) {
+    for (int v = 0; v < graph->num_vertices; v++) {
+        int p = atomic_load(&parent[v]);
+        if (p == -1 || v == root) {
+            continue;
+        }
+        if (atomic_load(&parent[p]) == -1) {
+            return false;
+        }
+
+        bool adjacent = false;
+        for (long e = graph->offsets[p]; e < graph->offsets[p + 1] && !adjacent; e++) {
+            adjacent = graph->neighbors[e] == v;
+        }
+        if (!adjacent) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// helper to run a plain top-down BFS with one queue, the baseline of the benchmark
+static long serial_bfs(const CsrGraph *graph, int root, int *parent, int *queue) {
+    for (int v = 0; v < graph->num_vertices; v++) {
+        parent[v] = -1;
+    }
+    parent[root] = root;
+    queue[0] = root;
+
+    long head = 0;
+    long tail = 1;
+    while (head < tail) {
+        int u = queue[head++];
+        for (long e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int v = graph->neighbors[e];
+            if (parent[v] == -1) {
+                parent[v] = u;
+                queue[tail++] = v;
+            }
+        }
+    }
+    return tail;
+}
+
+/*
+BFS benchmark on an RMAT graph
+
+traversed edges per second (TEPS) counts the input edges inside the component of the
+root, as in Graph500, for several roots with at least one neighbor
+*/
+#define BFS_BENCH_SCALE 20
+#define BFS_BENCH_EDGE_FACTOR 16
+#define BFS_BENCH_ROOTS 8
+
+void bfs_benchmark(void) {
+    int n = 1 << BFS_BENCH_SCALE;
+    long count = (long)n * BFS_BENCH_EDGE_FACTOR;
+    int *sources = (int*)malloc(count * sizeof(int));
+    int *targets = (int*)malloc(count * sizeof(int));
+
+    long long start = now_ns();
+    generate_rmat_edges(BFS_BENCH_SCALE, count, sources, targets, 12345);
+    CsrGraph graph = create_csr_graph(n, sources, targets, count, true);
+    long long build_time = now_ns() - start;
+    free(sources);
+    free(targets);
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int thread_count = cpus < 1 ? 1 : cpus > MAX_THREADS ? MAX_THREADS : (int)cpus;
+    atomic_int *parent = (atomic_int*)malloc(n * sizeof(atomic_int));
+    int *serial_parent = (int*)malloc(n * sizeof(int));
+    int *serial_queue = (int*)malloc(n * sizeof(int));
+
+    printf("\nBFS benchmark: RMAT scale %d, edge factor %d (generate + build CSR %.2f ms), %d threads\n",
+        BFS_BENCH_SCALE, BFS_BENCH_EDGE_FACTOR, build_time / 1e6, thread_count);
+
+    uint64_t state = 777;
+    double total_teps = 0;
+    double total_serial_teps = 0;
+    int runs = 0;
+    while (runs < BFS_BENCH_ROOTS) {
+        int root = (int)(rmat_random(&state) % n);
+        if (degree(&graph, root) == 0) {
+            continue;
+        }
+
+        start = now_ns();
+        long reached = parallel_bfs(&graph, root, parent, thread_count);
+        long long elapsed = now_ns() - start;
+
+        long component_edges = 0;
+        for (int v = 0; v < n; v++) {
+            if (atomic_load_explicit(&parent[v], memory_order_relaxed) != -1) {
+                component_edges += degree(&graph, v);
+            }
+        }
+        component_edges /= 2; // every input edge is stored twice
+
+        start = now_ns();
+        long serial_reached = serial_bfs(&graph, root, serial_parent, serial_queue);
+        long long serial_elapsed = now_ns() - start;
+
+        double teps = component_edges / (elapsed / 1e9);
+        double serial_teps = component_edges / (serial_elapsed / 1e9);
+        total_teps += teps;
+        total_serial_teps += serial_teps;
+        runs++;
+        printf("root %7d: %8ld vertices, %9ld edges, direction-optimizing %7.2f ms %7.1f M TEPS, serial top-down %7.2f ms %7.1f M TEPS %s\n",
+            root, reached, component_edges, elapsed / 1e6, teps / 1e6, serial_elapsed / 1e6, serial_teps / 1e6,
+            reached == serial_reached && bfs_check_parents(&graph, root, parent) ? "" : "(mismatch)");
+    }
+    printf("mean: direction-optimizing %.1f M TEPS, serial top-down %.1f M TEPS\n",
+        total_teps / runs / 1e6, total_serial_teps / runs / 1e6);
+
+    free(parent);
+    free(serial_parent);
+    free(serial_queue);
+    free_csr_graph(&graph);
+}
+
+// helper to compare two graphs array by array
+static bool same_graph(const CsrGraph *a, const CsrGraph *b) {
+    return a->num_vertices == b->num_vertices && a->num_edges == b->num_edges &&
+        memcmp(a->offsets, b->offsets, ((size_t)a->num_vertices + 1) * sizeof(long)) == 0 &&
+        memcmp(a->neighbors, b->neighbors, a->num_edges * sizeof(int)) == 0;
+}
+
+/*
+ingestion benchmark
+
+writes an RMAT edge list as text, then times parsing it with one and with all threads,
+relabeling, writing the binary CSR file and mapping it back. Every result is checked
+against the graph create_csr_graph builds from the same edges, and the cache must be
+turned down for other flags and for a rewritten edge list. The BFS runs from the same
+roots before and after relabeling show what the relabeling is worth.
+*/
+#define INGEST_BENCH_SCALE 20
+#define INGEST_BENCH_EDGE_FACTOR 16
+#define INGEST_BENCH_EDGE_PATH "/tmp/graph_bench_edges.txt"
+#define INGEST_BENCH_CACHE_PATH "/tmp/graph_bench_edges.csr"
+
+void ingest_benchmark(void) {
+    int n = 1 << INGEST_BENCH_SCALE;
+    long count = (long)n * INGEST_BENCH_EDGE_FACTOR;
+    int *sources = (int*)malloc(count * sizeof(int));
+    int *targets = (int*)malloc(count * sizeof(int));
+    generate_rmat_edges(INGEST_BENCH_SCALE, count, sources, targets, 4242);
+
+    FILE *file = fopen(INGEST_BENCH_EDGE_PATH, "w");
+    if (file == NULL) {
+        printf("\nCan't create %s.", INGEST_BENCH_EDGE_PATH);
+        free(sources);
+        free(targets);
+        return;
+    }
+    fprintf(file, "# RMAT scale %d, edge factor %d\n", INGEST_BENCH_SCALE, INGEST_BENCH_EDGE_FACTOR);
+    for (long i = 0; i < count; i++) {
+        fprintf(file, "%d\t%d\n", sources[i], targets[i]);
+    }
+    long file_size = ftell(file);
+    fclose(file);
+
+    // the parser takes the largest id + 1 as the vertex count, the reference has to agree
+    int max_vertex = 0;
+    for (long i = 0; i < count; i++) {
+        max_vertex = sources[i] > max_vertex ? sources[i] : max_vertex;
+        max_vertex = targets[i] > max_vertex ? targets[i] : max_vertex;
+    }
+    CsrGraph reference = create_csr_graph(max_vertex + 1, sources, targets, count, true);
+    free(sources);
+    free(targets);
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int thread_count = cpus < 1 ? 1 : cpus > MAX_THREADS ? MAX_THREADS : (int)cpus;
+    printf("\nIngestion benchmark: RMAT scale %d, edge factor %d, %.1f MB of text, %d threads\n",
+        INGEST_BENCH_SCALE, INGEST_BENCH_EDGE_FACTOR, file_size / 1e6, thread_count);
+
+    int thread_counts[] = { 1, thread_count };
+    CsrGraph graph = { 0 };
+    for (int i = 0; i < (thread_count > 1 ? 2 : 1); i++) {
+        long long start = now_ns();
+        bool loaded = load_edge_list(INGEST_BENCH_EDGE_PATH, true, thread_counts[i], &graph);
+        long long elapsed = now_ns() - start;
+
+        printf("parse + build CSR, %2d threads: %8.2f ms, %7.1f MB/s %s\n", thread_counts[i], elapsed / 1e6,
+            file_size / (elapsed / 1e9) / 1e6, loaded && same_graph(&graph, &reference) ? "" : "(mismatch)");
+        if (i == 0 && thread_count > 1) {
+            free_csr_graph(&graph);
+        }
+    }
+
+    long long start = now_ns();
+    CsrGraph relabeled;
+    if (!relabel_by_degree(&graph, thread_count, &relabeled)) {
+        printf("relabel by degree: (failed)\n");
+        free_csr_graph(&graph);
+        free_csr_graph(&reference);
+        unlink(INGEST_BENCH_EDGE_PATH);
+        return;
+    }
+    long long relabel_time = now_ns() - start;
+    const int *new_ids = relabeled.new_ids;
+
+    // relabeling is correct if every edge maps onto an edge and the degrees are sorted
+    bool relabel_valid = relabeled.num_edges == graph.num_edges;
+    for (int v = 0; v < graph.num_vertices && relabel_valid; v++) {
+        int u = new_ids[v];
+        relabel_valid = degree(&relabeled, u) == degree(&graph, v) &&
+            (u == 0 || degree(&relabeled, u - 1) >= degree(&relabeled, u));
+        for (long e = graph.offsets[v]; e < graph.offsets[v + 1] && relabel_valid; e++) {
+            int w = new_ids[graph.neighbors[e]];
+            relabel_valid = bsearch(&w, relabeled.neighbors + relabeled.offsets[u], degree(&relabeled, u),
+                sizeof(int), compare_int) != NULL;
+        }
+    }
+    printf("relabel by degree:             %8.2f ms %s\n", relabel_time / 1e6, relabel_valid ? "" : "(mismatch)");
+
+    CsrFileSource source;
+    csr_file_source(INGEST_BENCH_EDGE_PATH, true, true, &source);
+    start = now_ns();
+    bool saved = save_csr_graph(&relabeled, &source, INGEST_BENCH_CACHE_PATH);
+    long long save_time = now_ns() - start;
+
+    CsrGraph mapped = { 0 };
+    start = now_ns();
+    bool cached = ingest_graph(INGEST_BENCH_EDGE_PATH, INGEST_BENCH_CACHE_PATH, true, true, thread_count, &mapped);
+    long long map_time = now_ns() - start;
+
+    printf("write binary CSR:              %8.2f ms %s\n", save_time / 1e6, saved ? "" : "(failed)");
+    printf("ingest from binary CSR (mmap): %8.2f ms %s\n", map_time / 1e6,
+        cached && mapped.mapping != NULL && same_graph(&mapped, &relabeled) &&
+        memcmp(mapped.new_ids, new_ids, graph.num_vertices * sizeof(int)) == 0 ? "" : "(mismatch)");
+
+    // a cache built with other flags, or from an edge list that changed since, is turned down
+    CsrGraph stale = { 0 };
+    CsrFileSource other_flags = source;
+    other_flags.relabeled = false;
+    bool rejected_flags = !map_csr_graph(INGEST_BENCH_CACHE_PATH, &other_flags, &stale);
+
+    struct timespec times[2] = { { 0, UTIME_OMIT }, { 0, 0 } };
+    clock_gettime(CLOCK_REALTIME, &times[1]);
+    times[1].tv_nsec = (times[1].tv_nsec + 1) % 1000000000L; // a new time within the same second
+    utimensat(AT_FDCWD, INGEST_BENCH_EDGE_PATH, times, 0);
+    CsrFileSource touched;
+    csr_file_source(INGEST_BENCH_EDGE_PATH, true, true, &touched);
+    bool rejected_stale = !map_csr_graph(INGEST_BENCH_CACHE_PATH, &touched, &stale);
+    printf("cache turned down for other flags and a rewritten edge list %s\n",
+        rejected_flags && rejected_stale ? "" : "(mismatch)");
+
+    // the first BFS touches every page of the mapping, the rest run from the page cache
+    atomic_int *parent = (atomic_int*)malloc(graph.num_vertices * sizeof(atomic_int));
+    uint64_t state = 99;
+    long long original_time = 0;
+    long long relabeled_time = 0;
+    for (int runs = 0; runs < BFS_BENCH_ROOTS; ) {
+        int root = (int)(rmat_random(&state) % graph.num_vertices);
+        if (degree(&graph, root) == 0) {
+            continue;
+        }
+
+        start = now_ns();
+        long reached = parallel_bfs(&graph, root, parent, thread_count);
+        original_time += now_ns() - start;
+
+        start = now_ns();
+        long relabeled_reached = parallel_bfs(&mapped, new_ids[root], parent, thread_count);
+        relabeled_time += now_ns() - start;
+
+        if (reached != relabeled_reached) {
+            printf("(mismatch)\n");
+        }
+        runs++;
+    }
+    printf("BFS mean over %d roots: original ids %.2f ms, relabeled %.2f ms\n", BFS_BENCH_ROOTS,
+        original_time / 1e6 / BFS_BENCH_ROOTS, relabeled_time / 1e6 / BFS_BENCH_ROOTS);
+
+    free(parent);
+    free_csr_graph(&graph);
+    free_csr_graph(&relabeled);
+    free_csr_graph(&mapped);
+    free_csr_graph(&reference);
+    unlink(INGEST_BENCH_EDGE_PATH);
+    unlink(INGEST_BENCH_CACHE_PATH);
+}
+
+// main
+int main(int argc, char* argv[]) {
+    // small undirected graph: two triangles joined by the edge 2 - 3, and vertex 6 alone
+    int sources[] = { 0, 0, 1, 2, 3, 3, 4 };
+    int targets[] = { 1, 2, 2, 3, 4, 5, 5 };
+    CsrGraph graph = create_csr_graph(7, sources, targets, 7, true);
+    display_graph(&graph);
+
+    atomic_int parent[7];
+    long reached = parallel_bfs(&graph, 0, parent, 2);
+    printf("\nBFS from 0 reached %ld vertices:\n", reached);
+    for (int v = 0; v < graph.num_vertices; v++) {
+        printf("\tparent of %d: %d\n", v, atomic_load(&parent[v]));
+    }
+
+    free_csr_graph(&graph);
+
+    // benchmarks only run when asked for: ./graph bench
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bfs_benchmark();
+        ingest_benchmark();
+    }
+
+    return 0;
+}
@@ -1,8 +1,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
 
 #define MAX_CAPACITY 100
+#define CUCKOO_SLOTS 4         // fingerprints per filter bucket
+#define CUCKOO_MAX_KICKS 500   // evictions tried before the filter counts as full
+#define CUCKOO_MAX_LOAD 0.9    // fraction of filter slots in use the filter is sized for
+
+// returned by search for a missing key, callers can compare against it
+char NO_DATA_FOUND[] = "No data found.\n";
 
 /*
 this is using the separate chaining approach for the hash map
@@ -25,14 +34,50 @@ struct Node* initNode(struct Node* node, char* key, char* data) {
 
     // set next ptr to NULL since initially it is not pointing to any other node yet
     node->next = NULL;
-    return;
+    return node;
 }
 
+/*
+cuckoo filter (Fan, Andersen, Kaminsky and Mitzenmacher, CoNEXT 2014)
+
+an approximate set of keys that answers "definitely not in the map" or "maybe in the map"
+it stores a small fingerprint of every key in one of two candidate buckets:
+    bucket1 = hash(key)
+    bucket2 = bucket1 ^ hash(fingerprint)
+bucket2 only depends on bucket1 and the fingerprint, so a fingerprint can move between
+its two buckets without knowing the key. When both buckets are full an existing
+fingerprint is kicked to its other bucket to make room.
+unlike a Bloom filter a fingerprint can be removed again, so the filter follows deletes
+slots are 1 byte wide when the fingerprint fits in 8 bits and 2 bytes otherwise, so a
+bucket is one 4- or 8-byte word and a lookup compares its four fingerprints at once,
+a false positive happens when another key left the same fingerprint in one of the
+2 * CUCKOO_SLOTS slots, so the rate is about 2 * CUCKOO_SLOTS / 2^fingerprintBits
+*/
+typedef struct CuckooFilter {
+    void* slots;             // CUCKOO_SLOTS fingerprints per bucket, 0 marks an empty slot
+    size_t numBuckets;       // number of buckets, a power of two
+    int fingerprintBits;     // bits per fingerprint, more bits give fewer false positives
+    int slotBits;            // 8 or 16, the smallest slot that holds a fingerprint
+    int count;               // number of fingerprints in the filter
+    uint64_t randomState;    // picks which fingerprint gets kicked
+} CuckooFilter;
+
+// counters of how well the filter works, only updated while a filter is enabled
+typedef struct FilterStats {
+    long lookups;        // searches
+    long hits;           // searches that found the key
+    long filtered;       // misses answered by the filter without touching the buckets
+    long falsePositives; // misses the filter let through to the buckets
+} FilterStats;
+
 // hash map data structure
 typedef struct HashMap {
     int capacity;        // capacity of the hash map (number of buckets)
     int currNumElements; // current number of elements in the hash map
     struct Node** arr;   // pointer to a pointer to the array of the linked list
+    struct CuckooFilter* filter; // optional filter in front of the buckets, NULL when disabled
+    double falsePositiveRate;    // false positive rate the filter is tuned for
+    FilterStats stats;           // filter effectiveness
 } HashMap;
 
 // hash map constructor
@@ -48,10 +93,13 @@ struct HashMap* initHashMap(struct HashMap* map) {
                     of a linked list for a bucket
     sizeof(struct Node*) - size of a single pointer to a Node
     map->capacity - total number of buckets in the hash map
-    malloc() - allocates enough memory for all bucket pointers
+    calloc() - allocates enough memory for all bucket pointers and sets them to NULL (empty buckets)
     */
-    map->arr = (struct Node**)malloc(sizeof(struct Node*) * map->capacity);
-    return;
+    map->arr = (struct Node**)calloc(map->capacity, sizeof(struct Node*));
+    map->filter = NULL;
+    map->falsePositiveRate = 0;
+    memset(&map->stats, 0, sizeof(map->stats));
+    return map;
 }
 
 /*
@@ -93,14 +141,278 @@ int hashFunction(struct HashMap* map, char* key) {
     return bucketIndex;
 }
 
+/*
+method to compute the 64-bit hash the filter uses
+
+FNV-1a over the characters, then the murmur3 finalizer to spread the bits, because
+the low bits pick the filter bucket and the high bits the fingerprint
+*/
+uint64_t filterHash(char* key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char* c = (const unsigned char*)key; *c != '\0'; c++) {
+        hash = (hash ^ *c) * 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// fingerprint of a key, never 0 since 0 marks an empty slot
+static inline uint16_t fingerprint(struct CuckooFilter* filter, uint64_t hash) {
+    uint16_t fp = (uint16_t)((hash >> 32) & ((1u << filter->fingerprintBits) - 1));
+    return fp != 0 ? fp : 1;
+}
+
+// the other bucket of a fingerprint, applying it twice gives back the first bucket
+static inline size_t altBucket(struct CuckooFilter* filter, size_t bucket, uint16_t fp) {
+    return (bucket ^ (fp * 0x5bd1e995u)) & (filter->numBuckets - 1);
+}
+
+// fingerprint in slot i of the filter
+static inline uint16_t slotGet(struct CuckooFilter* filter, size_t i) {
+    return filter->slotBits == 8 ? ((uint8_t*)filter->slots)[i] : ((uint16_t*)filter->slots)[i];
+}
+
+// store fp in slot i of the filter
+static inline void slotSet(struct CuckooFilter* filter, size_t i, uint16_t fp) {
+    if (filter->slotBits == 8) {
+        ((uint8_t*)filter->slots)[i] = (uint8_t)fp;
+    }
+    else {
+        ((uint16_t*)filter->slots)[i] = fp;
+    }
+}
+
+/*
+check if any of the 4 slots of a bucket holds fp
+
+the bucket is read as one 32-bit (8-bit slots) or 64-bit (16-bit slots) word and
+xor-ed with fp copied into every lane, a lane becomes zero exactly where the
+fingerprint matches and the subtract trick finds a zero lane without a loop
+*/
+static inline bool bucketHas(struct CuckooFilter* filter, size_t bucket, uint16_t fp) {
+    if (filter->slotBits == 8) {
+        uint32_t word;
+        memcpy(&word, (uint8_t*)filter->slots + bucket * CUCKOO_SLOTS, sizeof(word));
+        uint32_t x = word ^ (0x01010101u * fp);
+        return ((x - 0x01010101u) & ~x & 0x80808080u) != 0;
+    }
+    uint64_t word;
+    memcpy(&word, (uint16_t*)filter->slots + bucket * CUCKOO_SLOTS, sizeof(word));
+    uint64_t x = word ^ (0x0001000100010001ULL * fp);
+    return ((x - 0x0001000100010001ULL) & ~x & 0x8000800080008000ULL) != 0;
+}
+
+// put fp in a free slot of the bucket if there is one
+static inline bool bucketAdd(struct CuckooFilter* filter, size_t bucket, uint16_t fp) {
+    for (size_t i = bucket * CUCKOO_SLOTS; i < (bucket + 1) * CUCKOO_SLOTS; i++) {
+        if (slotGet(filter, i) == 0) {
+            slotSet(filter, i, fp);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+filter constructor
+
+expectedKeys - number of keys the filter is sized for
+falsePositiveRate - picks the fingerprint size, the smallest one whose rate
+                    2 * CUCKOO_SLOTS / 2^bits is at most the requested rate (4 to 16 bits),
+                    rates down to 2 * CUCKOO_SLOTS / 2^8 (about 3%) fit 8-bit slots, lower
+                    ones take 16-bit slots and double the memory
+returns NULL if the slots can't be allocated
+*/
+struct CuckooFilter* initCuckooFilter(struct CuckooFilter* filter, int expectedKeys, double falsePositiveRate) {
+    size_t needed = (size_t)(expectedKeys / (CUCKOO_SLOTS * CUCKOO_MAX_LOAD)) + 1;
+
+    // a power of two number of buckets lets a mask replace the modulo
+    filter->numBuckets = 8;
+    while (filter->numBuckets < needed) {
+        filter->numBuckets *= 2;
+    }
+
+    filter->fingerprintBits = 4;
+    while (filter->fingerprintBits < 16 && 2.0 * CUCKOO_SLOTS / (1 << filter->fingerprintBits) > falsePositiveRate) {
+        filter->fingerprintBits++;
+    }
+
+    filter->slotBits = filter->fingerprintBits <= 8 ? 8 : 16;
+    // the table starts on a cache line, and aligned_alloc wants a multiple of the alignment,
+    // which the 32 bytes of 8 buckets with 8-bit slots aren't
+    size_t bytes = filter->numBuckets * CUCKOO_SLOTS * filter->slotBits / 8;
+    bytes = (bytes + 63) / 64 * 64;
+    filter->slots = aligned_alloc(64, bytes);
+    filter->count = 0;
+    if (filter->slots == NULL) {
+        return NULL;
+    }
+    memset(filter->slots, 0, bytes);
+    filter->randomState = 0x9e3779b97f4a7c15ULL;
+    return filter;
+}
+
+// method to free the filter's slots
+void freeCuckooFilter(struct CuckooFilter* filter) {
+    free(filter->slots);
+    filter->slots = NULL;
+    filter->count = 0;
+}
+
+// method to check if a key may be in the filter, false means it is definitely not
+bool cuckooContains(struct CuckooFilter* filter, uint64_t hash) {
+    uint16_t fp = fingerprint(filter, hash);
+    size_t bucket = hash & (filter->numBuckets - 1);
+    return bucketHas(filter, bucket, fp) || bucketHas(filter, altBucket(filter, bucket, fp), fp);
+}
+
+/*
+method to add a key to the filter
+
+if both buckets are full a random fingerprint of one of them is kicked to its other
+bucket, which may kick another one, up to CUCKOO_MAX_KICKS times
+returns false when the filter is too full, a fingerprint is then left out and the
+filter has to be rebuilt larger
+*/
+bool cuckooInsert(struct CuckooFilter* filter, uint64_t hash) {
+    uint16_t fp = fingerprint(filter, hash);
+    size_t bucket = hash & (filter->numBuckets - 1);
+    size_t other = altBucket(filter, bucket, fp);
+
+    if (bucketAdd(filter, bucket, fp) || bucketAdd(filter, other, fp)) {
+        filter->count++;
+        return true;
+    }
+
+    for (int kick = 0; kick < CUCKOO_MAX_KICKS; kick++) {
+        // xorshift to pick the bucket and slot to kick from
+        filter->randomState ^= filter->randomState << 13;
+        filter->randomState ^= filter->randomState >> 7;
+        filter->randomState ^= filter->randomState << 17;
+
+        if (kick == 0 && (filter->randomState & 64)) {
+            bucket = other;
+        }
+        size_t slot = bucket * CUCKOO_SLOTS + filter->randomState % CUCKOO_SLOTS;
+        uint16_t kicked = slotGet(filter, slot);
+        slotSet(filter, slot, fp);
+        fp = kicked;
+
+        bucket = altBucket(filter, bucket, fp);
+        if (bucketAdd(filter, bucket, fp)) {
+            filter->count++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// method to remove one copy of a key's fingerprint, only call it for keys that were inserted
+void cuckooDelete(struct CuckooFilter* filter, uint64_t hash) {
+    uint16_t fp = fingerprint(filter, hash);
+    size_t buckets[2];
+    buckets[0] = hash & (filter->numBuckets - 1);
+    buckets[1] = altBucket(filter, buckets[0], fp);
+
+    for (int b = 0; b < 2; b++) {
+        for (size_t i = buckets[b] * CUCKOO_SLOTS; i < (buckets[b] + 1) * CUCKOO_SLOTS; i++) {
+            if (slotGet(filter, i) == fp) {
+                slotSet(filter, i, 0);
+                filter->count--;
+                return;
+            }
+        }
+    }
+}
+
+/*
+method to (re)build the map's filter from the keys in the buckets
+
+the filter only stores fingerprints, so when it is too full to take another key it
+can't grow by itself, but the map still has every key, so a larger filter is built
+from them instead
+if even much larger filters fail (keys with identical hashes) or memory runs out the
+filter is dropped and false returned, search still works without it
+*/
+static bool rebuildFilter(struct HashMap* map, int expectedKeys) {
+    if (map->filter == NULL) {
+        map->filter = (struct CuckooFilter*)malloc(sizeof(struct CuckooFilter));
+        if (map->filter == NULL) {
+            return false;
+        }
+    }
+    else {
+        freeCuckooFilter(map->filter);
+    }
+
+    for (int attempt = 0; attempt < 8; attempt++, expectedKeys *= 2) {
+        if (initCuckooFilter(map->filter, expectedKeys, map->falsePositiveRate) == NULL) {
+            break;
+        }
+
+        bool complete = true;
+        for (int i = 0; i < map->capacity && complete; i++) {
+            for (struct Node* node = map->arr[i]; node != NULL && complete; node = node->next) {
+                complete = cuckooInsert(map->filter, filterHash(node->key));
+            }
+        }
+        if (complete) {
+            return true;
+        }
+        freeCuckooFilter(map->filter);
+    }
+
+    free(map->filter);
+    map->filter = NULL;
+    return false;
+}
+
+/*
+method to put a cuckoo filter in front of the hash map
+
+after this most searches for missing keys are answered by the filter, without hashing
+into the buckets or walking a chain
+expectedKeys - number of keys to size the filter for, it is rebuilt larger if more arrive
+falsePositiveRate - fraction of misses that still go to the buckets, e.g. 0.01
+                    rates of about 3% and above use 8-bit slots, lower ones 16-bit
+                    slots (see initCuckooFilter)
+returns false if the filter can't be built, the map then works without one
+*/
+bool enableFilter(struct HashMap* map, int expectedKeys, double falsePositiveRate) {
+    map->falsePositiveRate = falsePositiveRate;
+    memset(&map->stats, 0, sizeof(map->stats));
+    return rebuildFilter(map, expectedKeys > map->currNumElements ? expectedKeys : map->currNumElements);
+}
+
+// method to remove the filter, searches go straight to the buckets again
+void disableFilter(struct HashMap* map) {
+    if (map->filter != NULL) {
+        freeCuckooFilter(map->filter);
+        free(map->filter);
+        map->filter = NULL;
+    }
+}
+
 /*
 method to insert data into hash map
+
+if the key is already in the map its data is replaced
 */
 void insert(struct HashMap* map, char* key, char* data) {
     // perform hash function on element key to get index and store into bucket
     int bucketIndex = hashFunction(map, key);
 
-    printf("Inserting key '%s' with data '%s'.\n", key, data);
+    // if the key is already stored, only update its data
+    for (struct Node* node = map->arr[bucketIndex]; node != NULL; node = node->next) {
+        if (strcmp(node->key, key) == 0) {
+            node->data = data;
+            return;
+        }
+    }
 
     // create new node to store the key-value pair
     struct Node *newNode = (struct Node*)malloc(sizeof(struct Node));
@@ -118,6 +430,12 @@ void insert(struct HashMap* map, char* key, char* data) {
         newNode->next = map->arr[bucketIndex]; // link new node to existing list at the bucket
         map->arr[bucketIndex] = newNode; // make new node the head of linked list at the bucket index
     }
+    map->currNumElements++;
+
+    // keep the filter in sync, a full filter is rebuilt with room for twice the keys
+    if (map->filter != NULL && !cuckooInsert(map->filter, filterHash(key))) {
+        rebuildFilter(map, 2 * map->currNumElements);
+    }
 
     return;
 }
@@ -126,13 +444,43 @@ void insert(struct HashMap* map, char* key, char* data) {
 method to delete data from hash map
 */
 void delete(struct HashMap* map, char* key) {
-    //
+    int bucketIndex = hashFunction(map, key);
+
+    // link points at the pointer to the current node, so unlinking the head needs no special case
+    struct Node** link = &map->arr[bucketIndex];
+
+    while (*link != NULL) {
+        if (strcmp((*link)->key, key) == 0) {
+            struct Node* node = *link;
+            *link = node->next; // unlink node from the chain
+            free(node);
+            map->currNumElements--;
+
+            // keep the filter in sync
+            if (map->filter != NULL) {
+                cuckooDelete(map->filter, filterHash(key));
+            }
+            return;
+        }
+        link = &(*link)->next;
+    }
+
+    printf("Key '%s' not found.\n", key);
 }
 
 /*
 method to search for data in the hash map
 */
 char* search(struct HashMap* map, char* key) {
+    // a key the filter has never seen is not in the map, skip the buckets
+    if (map->filter != NULL) {
+        map->stats.lookups++;
+        if (!cuckooContains(map->filter, filterHash(key))) {
+            map->stats.filtered++;
+            return NO_DATA_FOUND;
+        }
+    }
+
     // get bucket index for the given key
     int bucketIndex = hashFunction(map, key);
 
@@ -143,8 +491,11 @@ char* search(struct HashMap* map, char* key) {
     // travere linked list at the bucket index until end of list
     while (bucketHead != NULL) {
         // key is found at the bucket (head of the linked list)
-        // key in the current node matches search key
-        if (bucketHead->key == key) {
+        // key in the current node matches search key (compare the characters, not the pointers)
+        if (strcmp(bucketHead->key, key) == 0) {
+            if (map->filter != NULL) {
+                map->stats.hits++;
+            }
             return bucketHead->data; // return associated data
         }
 
@@ -152,10 +503,128 @@ char* search(struct HashMap* map, char* key) {
     }
 
     // if no key is found in hash map
-    char* msg = "No data found.\n";
-    char* errorMsg = (char*)malloc(sizeof(char) * (strlen(errorMsg) + 1));
-    strcpy(errorMsg, msg);
-    return errorMsg;
+    // the filter let a missing key through
+    if (map->filter != NULL) {
+        map->stats.falsePositives++;
+    }
+    return NO_DATA_FOUND; // shared message, nothing to allocate or free
+}
+
+// method to print how well the filter works
+void printFilterStats(struct HashMap* map) {
+    if (map->filter == NULL) {
+        printf("No filter.\n");
+        return;
+    }
+
+    struct CuckooFilter* filter = map->filter;
+    long misses = map->stats.filtered + map->stats.falsePositives;
+    double bitsPerKey = filter->count > 0 ? (double)filter->numBuckets * CUCKOO_SLOTS * filter->slotBits / filter->count : 0;
+
+    printf("Filter: %d keys, %d-bit fingerprints in %d-bit slots, %.1f bits per key, target false positive rate %.4f%%\n",
+        filter->count, filter->fingerprintBits, filter->slotBits, bitsPerKey, 100 * map->falsePositiveRate);
+    printf("Lookups: %ld, hits: %ld, misses: %ld, filtered: %ld, false positives: %ld (measured rate %.4f%%)\n",
+        map->stats.lookups, map->stats.hits, misses, map->stats.filtered, map->stats.falsePositives,
+        misses > 0 ? 100.0 * map->stats.falsePositives / misses : 0);
+}
+
+// method to free the nodes, buckets and filter of the hash map (keys and data belong to the caller)
+void freeHashMap(struct HashMap* map) {
+    for (int i = 0; i < map->capacity; i++) {
+        struct Node* node = map->arr[i];
+        while (node != NULL) {
+            struct Node* next = node->next;
+            free(node);
+            node = next;
+        }
+    }
+    free(map->arr);
+    map->arr = NULL;
+    map->currNumElements = 0;
+    disableFilter(map);
+}
+
+// helper to read a monotonic clock in nanoseconds
+static inline long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+filter benchmark
+
+fills a map with FILTER_BENCH_KEYS keys and times searches for present and missing keys
+without a filter and with filters tuned for several false positive rates
+then deletes half of the keys and checks that the filter followed: deleted keys must
+miss and the remaining keys must all still be found (a filter never has false negatives)
+*/
+#define FILTER_BENCH_KEYS 20000
+#define FILTER_BENCH_SEARCHES 200000
+#define FILTER_BENCH_KEY_LENGTH 24
+
+// helper to time FILTER_BENCH_SEARCHES searches over the given keys, returns ns per search
+static double timeSearches(struct HashMap* map, char (*keys)[FILTER_BENCH_KEY_LENGTH], int count, bool expectHit, bool* correct) {
+    long long start = now_ns();
+    for (int i = 0; i < FILTER_BENCH_SEARCHES; i++) {
+        char* data = search(map, keys[i % count]);
+        if ((data != NO_DATA_FOUND) != expectHit) {
+            *correct = false;
+        }
+    }
+    return (double)(now_ns() - start) / FILTER_BENCH_SEARCHES;
+}
+
+void filterBenchmark(void) {
+    char (*keys)[FILTER_BENCH_KEY_LENGTH] = malloc(FILTER_BENCH_KEYS * FILTER_BENCH_KEY_LENGTH);
+    char (*missing)[FILTER_BENCH_KEY_LENGTH] = malloc(FILTER_BENCH_KEYS * FILTER_BENCH_KEY_LENGTH);
+    for (int i = 0; i < FILTER_BENCH_KEYS; i++) {
+        snprintf(keys[i], FILTER_BENCH_KEY_LENGTH, "key-%d", i);
+        snprintf(missing[i], FILTER_BENCH_KEY_LENGTH, "missing-%d", i);
+    }
+
+    struct HashMap map;
+    initHashMap(&map);
+    for (int i = 0; i < FILTER_BENCH_KEYS; i++) {
+        insert(&map, keys[i], keys[i]);
+    }
+
+    printf("\nFilter benchmark: %d keys in %d buckets, %d searches each\n", FILTER_BENCH_KEYS, map.capacity, FILTER_BENCH_SEARCHES);
+
+    bool correct = true;
+    double miss = timeSearches(&map, missing, FILTER_BENCH_KEYS, false, &correct);
+    double hit = timeSearches(&map, keys, FILTER_BENCH_KEYS, true, &correct);
+    printf("no filter:           miss %8.1f ns, hit %8.1f ns %s\n", miss, hit, correct ? "" : "(mismatch)");
+
+    double rates[] = { 0.05, 0.01, 0.001, 0.0001 };
+    for (int r = 0; r < 4; r++) {
+        if (!enableFilter(&map, FILTER_BENCH_KEYS, rates[r])) {
+            printf("filter, rate %.2f%%: (failed)\n", 100 * rates[r]);
+            continue;
+        }
+        correct = true;
+        miss = timeSearches(&map, missing, FILTER_BENCH_KEYS, false, &correct);
+        hit = timeSearches(&map, keys, FILTER_BENCH_KEYS, true, &correct);
+        printf("filter, rate %.2f%%: miss %8.1f ns, hit %8.1f ns %s\n", 100 * rates[r], miss, hit, correct ? "" : "(mismatch)");
+        printFilterStats(&map);
+    }
+
+    // delete every other key, the filter has to follow
+    for (int i = 0; i < FILTER_BENCH_KEYS; i += 2) {
+        delete(&map, keys[i]);
+    }
+    correct = map.currNumElements == FILTER_BENCH_KEYS / 2;
+    for (int i = 0; i < FILTER_BENCH_KEYS; i++) {
+        if ((search(&map, keys[i]) != NO_DATA_FOUND) != (i % 2 == 1)) {
+            correct = false;
+        }
+    }
+    printf("after deleting half of the keys: %d keys in the filter %s\n", map.filter != NULL ? map.filter->count : 0,
+        correct ? "" : "(mismatch)");
+
+    freeHashMap(&map);
+    free(keys);
+    free(missing);
 }
 
 // main
@@ -165,8 +634,11 @@ int main(int argc, char* argv[]) {
     initHashMap(map);
 
     // insert key-value pairs into hash map
+    printf("Inserting key '%s' with data '%s'.\n", "username", "Kelsey");
     insert(map, "username", "Kelsey");
+    printf("Inserting key '%s' with data '%s'.\n", "age", "22");
     insert(map, "age", "22");
+    printf("Inserting key '%s' with data '%s'.\n", "role", "user");
     insert(map, "role", "user");
 
     // find data associated with keys
@@ -175,5 +647,21 @@ int main(int argc, char* argv[]) {
     printf("Data: %s\n", search(map, "role"));
     printf("Data: %s\n", search(map, "invalid_key"));
 
+    // put a filter in front of the buckets, then delete a key
+    enableFilter(map, 100, 0.01);
+    delete(map, "age");
+    printf("Data: %s\n", search(map, "username"));
+    printf("Data: %s\n", search(map, "age"));
+    printf("Data: %s\n", search(map, "invalid_key"));
+    printFilterStats(map);
+
+    freeHashMap(map);
+    free(map);
+
+    // benchmarks only run when asked for: ./hash bench
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        filterBenchmark();
+    }
+
     return 0;
 }
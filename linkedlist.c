@@ -273,6 +273,257 @@ void deleteAtPosition(struct Node** head, int position) {
     temp->next = next; // redirect the next pointer of temp node to skip over the deleted node
 }
 
+/*
+helper to cut a list after its first n nodes
+
+detachAfter:
+    Time Complexity: O(n)
+    Space Complexity: O(1)
+    Walks n - 1 nodes to find the cut point, sets that node's next pointer to NULL
+    and returns the head of the remaining nodes (NULL if the list was shorter than n).
+    No node is allocated or freed.
+*/
+static struct Node* detachAfter(struct Node* head, int n) {
+    for (int i = 1; head != NULL && i < n; i++) {
+        head = head->next;
+    }
+
+    if (head == NULL) {
+        return NULL;
+    }
+
+    struct Node* rest = head->next;
+    head->next = NULL; // terminate the first part
+    return rest;
+}
+
+/*
+helper to merge two sorted runs by relinking their nodes
+
+mergeRuns:
+    Time Complexity: O(n + m)
+    Space Complexity: O(1)
+    Each step compares the two front nodes and links the smaller one to the end of the
+    result, so every node is visited once. Keeping a pointer to the link that receives
+    the next node removes the special case for the first link, and no node is allocated.
+    Ties take the node from a first, which keeps the merge stable. The last node of the
+    result is written to *tail (NULL if both runs are empty).
+*/
+static struct Node* mergeRuns(struct Node* a, struct Node* b, struct Node** tail) {
+    struct Node* head = NULL;
+    struct Node** link = &head; // where the next node gets linked
+    struct Node* last = NULL;
+
+    while (a != NULL && b != NULL) {
+        if (b->data < a->data) {
+            last = b;
+            b = b->next;
+        }
+        else {
+            last = a;
+            a = a->next;
+        }
+        *link = last;
+        link = &last->next;
+    }
+
+    // at most one run still has nodes, link all of them at once
+    *link = (a != NULL) ? a : b;
+    for (struct Node* temp = *link; temp != NULL; temp = temp->next) {
+        last = temp;
+    }
+
+    *tail = last;
+    return head;
+}
+
+/*
+method to merge two sorted linked lists into one sorted linked list
+
+mergeSortedLists:
+    Time Complexity: O(n + m)
+    Space Complexity: O(1)
+    The nodes of both lists are relinked in place, so no memory is allocated.
+    Both input lists are consumed, only the returned head should be used afterwards.
+*/
+struct Node* mergeSortedLists(struct Node* first, struct Node* second) {
+    printf("\nMerging two sorted linked lists.\n");
+
+    struct Node* tail;
+    return mergeRuns(first, second, &tail);
+}
+
+/*
+method to sort linked list in ascending order (bottom-up merge sort)
+
+mergeSort:
+    Time Complexity: O(n log n)
+    Space Complexity: O(1)
+    The top-down version needs O(log n) recursion and a slow/fast pointer walk to find
+    each middle. The bottom-up version instead merges neighbouring runs of width
+    1, 2, 4, ... until one run covers the whole list. Every pass is linear and there are
+    log n passes. Nodes are only relinked, never allocated or copied, and equal values
+    keep their original order (stable sort).
+    Returns the last node of the sorted list so the caller can concatenate in O(1).
+*/
+struct Node* mergeSort(struct Node** head) {
+    printf("\nSorting linked list.\n");
+
+    // an empty list or a single node is already sorted
+    if (*head == NULL || (*head)->next == NULL) {
+        return *head;
+    }
+
+    // count nodes once so we know when a single run covers the whole list
+    int length = 0;
+    for (struct Node* temp = *head; temp != NULL; temp = temp->next) {
+        length++;
+    }
+
+    struct Node* tail = NULL;
+
+    for (int width = 1; width < length; width *= 2) {
+        struct Node* current = *head;
+        struct Node* last = NULL; // last node of the already merged part of this pass
+
+        while (current != NULL) {
+            // cut two runs of size width from the front of the remaining nodes
+            struct Node* left = current;
+            struct Node* right = detachAfter(left, width);
+            current = detachAfter(right, width);
+
+            // merge them and link the result behind the previous merged runs
+            struct Node* mergedTail;
+            struct Node* merged = mergeRuns(left, right, &mergedTail);
+            if (last == NULL) {
+                *head = merged; // first merged run of the pass is the new head
+            }
+            else {
+                last->next = merged;
+            }
+            last = mergedTail;
+        }
+        tail = last;
+    }
+
+    return tail;
+}
+
+/*
+method to split linked list into two lists at a specific position
+
+splitAtPosition:
+    Time Complexity: O(n)
+    Space Complexity: O(1)
+    Traverses to the node just before position and cuts the link there. The nodes from
+    position onwards are returned as a separate list, and head keeps the nodes before it.
+    Returns NULL if position is out of range.
+*/
+struct Node* splitAtPosition(struct Node** head, int position) {
+    printf("\nSplitting linked list at index %d.\n", position);
+
+    if (position < 0) {
+        printf("\nPosition out of range.\n");
+        return NULL;
+    }
+
+    // splitting at index 0 moves the whole list to the second part
+    if (position == 0) {
+        struct Node* second = *head;
+        *head = NULL;
+        return second;
+    }
+
+    struct Node* temp = *head;
+    for (int i = 0; temp != NULL && i < position - 1; i++) {
+        temp = temp->next;
+    }
+
+    if (temp == NULL) {
+        printf("\nPosition out of range.\n");
+        return NULL;
+    }
+
+    struct Node* second = temp->next;
+    temp->next = NULL; // the node before position is now the end of the first list
+    return second;
+}
+
+/*
+method to append another linked list to the end of a linked list
+
+concatenate:
+    Time Complexity: O(1) when tail is known, O(n) otherwise
+    Space Complexity: O(1)
+    With a tail pointer only the last node's next pointer is changed. If *tail is NULL
+    the end of the first list is found by traversing it. otherTail may also be NULL, in
+    which case the new tail is found by traversing the second list.
+    *tail is updated to the last node of the combined list.
+*/
+void concatenate(struct Node** head, struct Node** tail, struct Node* otherHead, struct Node* otherTail) {
+    printf("\nConcatenating linked lists.\n");
+
+    if (otherHead == NULL) {
+        return;
+    }
+
+    // find the missing tail pointers by traversal
+    if (*tail == NULL) {
+        for (struct Node* temp = *head; temp != NULL; temp = temp->next) {
+            *tail = temp;
+        }
+    }
+    if (otherTail == NULL) {
+        otherTail = otherHead;
+        while (otherTail->next != NULL) {
+            otherTail = otherTail->next;
+        }
+    }
+
+    // if first list is empty, the second list becomes the whole list
+    if (*head == NULL) {
+        *head = otherHead;
+    }
+    else {
+        (*tail)->next = otherHead;
+    }
+    *tail = otherTail;
+}
+
+/*
+method to insert a whole linked list after a given node
+
+splice:
+    Time Complexity: O(1), O(m) if otherTail is NULL and the inserted list has m nodes
+    Space Complexity: O(1)
+    The first and last node of the inserted list are linked between position and the
+    node that followed it, so only two pointers change no matter how long either list is.
+    Like concatenate, a NULL otherTail is found by traversal.
+*/
+void splice(struct Node* position, struct Node* otherHead, struct Node* otherTail) {
+    if (position == NULL) {
+        printf("\nPosition out of range.\n");
+        return;
+    }
+
+    printf("\nSplicing linked list after node %d.\n", position->data);
+
+    if (otherHead == NULL) {
+        return;
+    }
+
+    // find the missing tail pointer by traversal
+    if (otherTail == NULL) {
+        otherTail = otherHead;
+        while (otherTail->next != NULL) {
+            otherTail = otherTail->next;
+        }
+    }
+
+    otherTail->next = position->next; // end of inserted list points to the rest
+    position->next = otherHead; // position now points to start of inserted list
+}
+
 // main
 int main(int argc, char* argv[]) {
     struct Node* head = NULL;
@@ -302,5 +553,33 @@ int main(int argc, char* argv[]) {
     deleteAtPosition(&head, 1);
     display_linked_list(head);
 
+    insertAtFirst(&head, 42);
+    insertAtEnd(&head, 7);
+    insertAtEnd(&head, 64);
+    insertAtEnd(&head, 3);
+    display_linked_list(head);
+
+    struct Node* tail = mergeSort(&head);
+    display_linked_list(head);
+
+    struct Node* other = NULL;
+    insertAtEnd(&other, 1);
+    insertAtEnd(&other, 50);
+    insertAtEnd(&other, 99);
+    head = mergeSortedLists(head, other);
+    display_linked_list(head);
+
+    struct Node* second = splitAtPosition(&head, 3);
+    display_linked_list(head);
+    display_linked_list(second);
+
+    tail = NULL;
+    concatenate(&head, &tail, second, NULL);
+    display_linked_list(head);
+
+    struct Node* extra = createNode(500);
+    splice(head, extra, extra);
+    display_linked_list(head);
+
     return 0;
 }
@@ -1,8 +1,30 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 #define MAX_SIZE 10
+#define RING_MIN_CAPACITY 16 // smallest ring buffer, must be a power of two
+#define RING_MAX_CAPACITY (1u << 31) // largest power of two an unsigned int counter can hold
+#define CACHE_LINE_SIZE 64 // bytes, used to keep indices of different threads apart
+#define SPIN_LIMIT 64 // busy-wait attempts before giving the cpu away
+#define PQ_ARITY 4 // children per node in the priority queue heap
+#define WS_MIN_CAPACITY 64 // initial slots of a work-stealing deque, must be a power of two
+#define POOL_MAX_THREADS 64 // most threads a thread pool can have
 
 // queue class
 typedef struct Queue {
@@ -11,6 +33,12 @@ typedef struct Queue {
     int rear; // indicates index to be enqueued
 } Queue;
 
+// array class (same layout as Array in array.c)
+typedef struct Array {
+    int *data; // array data (integers)
+    int size; // size of array
+} Array;
+
 // method to initialize queue
 void init_queue(Queue *queue) {
     // set front index to -1 which indicates empty queue
@@ -141,34 +169,1965 @@ int peek(Queue *queue) {
     return printf("\nFront of queue : %d\n", queue->arr[queue->front + 1]);
 }
 
-// main
-int main(int argc, char* argv[]) {
-    Queue queue;
-    init_queue(&queue);
-    display_queue(&queue);
+/*
+ring buffer queue class
 
-    enqueue(&queue, 5);
-    enqueue(&queue, 10);
-    enqueue(&queue, 20);
-    enqueue(&queue, 40);
-    enqueue(&queue, 80);
-    enqueue(&queue, 160);
-    enqueue(&queue, 320);
-    enqueue(&queue, 640);
-    enqueue(&queue, 1280);
-    enqueue(&queue, 2560);
-    
-    display_queue(&queue);
-    
-    dequeue(&queue);
-    dequeue(&queue);
-    dequeue(&queue);
-    dequeue(&queue);
-    dequeue(&queue);
+Queue above never reuses a slot: front and rear only move forward, so after MAX_SIZE
+enqueues it reports full even if every element was dequeued. RingQueue wraps around.
+head and tail are free running counters, the slot of a counter is (counter & mask).
+Because capacity is a power of two, the bitmask replaces the slower % operator and
+unsigned overflow of the counters is harmless. The number of elements is tail - head,
+so no slot is wasted to tell a full queue from an empty one.
+*/
+typedef struct RingQueue {
+    int *arr; // buffer of capacity elements
+    unsigned int capacity; // always a power of two
+    unsigned int mask; // capacity - 1
+    unsigned int head; // counter of the next element to be dequeued
+    unsigned int tail; // counter of the next element to be enqueued
+} RingQueue;
 
-    display_queue(&queue);
+// helper to round a capacity up to the next power of two, returns 0 if n is above RING_MAX_CAPACITY
+static unsigned int round_up_pow2(unsigned int n) {
+    if (n > RING_MAX_CAPACITY) {
+        return 0; // doubling would wrap to 0 and never reach n
+    }
 
-    peek(&queue);
+    unsigned int capacity = RING_MIN_CAPACITY;
+    while (capacity < n) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+// method to initialize ring queue with room for at least capacity elements
+bool init_ring_queue(RingQueue *queue, unsigned int capacity) {
+    queue->capacity = round_up_pow2(capacity);
+    queue->mask = queue->capacity - 1;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->arr = queue->capacity != 0 ? (int*)malloc(queue->capacity * sizeof(int)) : NULL;
+    return queue->arr != NULL;
+}
+
+// method to free the buffer of a ring queue
+void free_ring_queue(RingQueue *queue) {
+    free(queue->arr);
+    queue->arr = NULL;
+    queue->capacity = 0;
+    queue->mask = 0;
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+// method to return the number of elements in the ring queue
+unsigned int ring_size(RingQueue *queue) {
+    return queue->tail - queue->head;
+}
+
+// method to check if ring queue is empty
+bool ring_is_empty(RingQueue *queue) {
+    return queue->tail == queue->head;
+}
+
+/*
+method to grow the ring buffer so it can hold at least needed elements
+
+Grow:
+    Time Complexity: O(n)
+    Space Complexity: O(n)
+    The elements may wrap around the end of the old buffer. They are unrolled into the
+    new buffer with at most two memcpy calls: first from head to the end of the old
+    buffer, then from the start of the old buffer to tail. Afterwards head is 0 and
+    tail is the size. Capacity doubles, so enqueue stays amortized O(1).
+    Fails without touching the queue if needed is above RING_MAX_CAPACITY.
+*/
+static bool ring_grow(RingQueue *queue, unsigned int needed) {
+    if (needed > RING_MAX_CAPACITY) {
+        return false;
+    }
+
+    unsigned int capacity = queue->capacity;
+    while (capacity < needed) {
+        capacity <<= 1;
+    }
+
+    int *arr = (int*)malloc(capacity * sizeof(int));
+    if (arr == NULL) {
+        return false;
+    }
+
+    unsigned int size = ring_size(queue);
+    unsigned int start = queue->head & queue->mask;
+    unsigned int first = queue->capacity - start; // elements before the end of the old buffer
+    if (first > size) {
+        first = size;
+    }
+
+    memcpy(arr, queue->arr + start, first * sizeof(int));
+    memcpy(arr + first, queue->arr, (size - first) * sizeof(int));
+
+    free(queue->arr);
+    queue->arr = arr;
+    queue->capacity = capacity;
+    queue->mask = capacity - 1;
+    queue->head = 0;
+    queue->tail = size;
+    return true;
+}
+
+/*
+method to insert element to ring queue
+
+Ring enqueue:
+    Time Complexity: O(1) (Amortized)
+    Space Complexity: O(1)
+    The value is stored at tail & mask. Only when the buffer is full it is doubled,
+    which is rare enough that the copy cost averages out to constant per element.
+*/
+bool ring_enqueue(RingQueue *queue, int value) {
+    if (ring_size(queue) == queue->capacity && !ring_grow(queue, queue->capacity + 1)) {
+        return false;
+    }
+
+    queue->arr[queue->tail & queue->mask] = value;
+    queue->tail++;
+    return true;
+}
+
+/*
+method to remove element from ring queue
+
+Ring dequeue:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    Reads the value at head & mask and moves head forward. The slot is reused once
+    tail wraps around to it. Returns false if the queue is empty.
+*/
+bool ring_dequeue(RingQueue *queue, int *value) {
+    if (ring_is_empty(queue)) {
+        return false;
+    }
+
+    *value = queue->arr[queue->head & queue->mask];
+    queue->head++;
+    return true;
+}
+
+// method to return element at front of ring queue without removing it
+bool ring_peek(RingQueue *queue, int *value) {
+    if (ring_is_empty(queue)) {
+        return false;
+    }
+
+    *value = queue->arr[queue->head & queue->mask];
+    return true;
+}
+
+/*
+method to insert n elements to ring queue
+
+Ring enqueue n:
+    Time Complexity: O(n)
+    Space Complexity: O(1) (Amortized)
+    The free space starting at tail is at most two contiguous spans: up to the end of
+    the buffer and then from its start. Both are filled with one memcpy each instead
+    of n separate enqueues. The buffer grows once up front if the values don't fit.
+*/
+bool ring_enqueue_n(RingQueue *queue, const int *values, unsigned int n) {
+    unsigned int size = ring_size(queue);
+
+    // size + n could wrap around, compare against the room that is left instead
+    if (n > RING_MAX_CAPACITY - size) {
+        return false;
+    }
+    if (size + n > queue->capacity && !ring_grow(queue, size + n)) {
+        return false;
+    }
+
+    unsigned int start = queue->tail & queue->mask;
+    unsigned int first = queue->capacity - start; // free slots before the end of the buffer
+    if (first > n) {
+        first = n;
+    }
+
+    memcpy(queue->arr + start, values, first * sizeof(int));
+    memcpy(queue->arr, values + first, (n - first) * sizeof(int));
+    queue->tail += n;
+    return true;
+}
+
+/*
+method to remove up to n elements from ring queue
+
+Ring dequeue n:
+    Time Complexity: O(n)
+    Space Complexity: O(1)
+    Same as enqueue n in reverse: the elements starting at head are copied out with
+    at most two memcpy calls. Returns how many elements were dequeued.
+*/
+unsigned int ring_dequeue_n(RingQueue *queue, int *values, unsigned int n) {
+    unsigned int size = ring_size(queue);
+    if (n > size) {
+        n = size;
+    }
+
+    unsigned int start = queue->head & queue->mask;
+    unsigned int first = queue->capacity - start; // elements before the end of the buffer
+    if (first > n) {
+        first = n;
+    }
+
+    memcpy(values, queue->arr + start, first * sizeof(int));
+    memcpy(values + first, queue->arr, (n - first) * sizeof(int));
+    queue->head += n;
+    return n;
+}
+
+// method to display current ring queue
+void display_ring_queue(RingQueue *queue) {
+    if (ring_is_empty(queue)) {
+        printf("\nRing queue is empty.\n");
+        return;
+    }
+
+    printf("\nCurrent Ring Queue (%u/%u):", ring_size(queue), queue->capacity);
+    printf("\n(front) ");
+    for (unsigned int i = queue->head; i != queue->tail; i++) {
+        printf("%d ", queue->arr[i & queue->mask]);
+    }
+    printf("(rear)\n");
+}
+
+// helper to tell the cpu we are busy-waiting (saves power and helps the sibling hyperthread)
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+// helper for spin loops: pause for a while, then yield so a waiting thread on the same core can run
+static inline void spin_wait(unsigned int *spins) {
+    if (++(*spins) < SPIN_LIMIT) {
+        cpu_relax();
+    }
+    else {
+        sched_yield();
+    }
+}
+
+// helper to read a monotonic clock in nanoseconds
+static inline long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+single-producer/single-consumer queue class (lock-free)
+
+Exactly one thread may enqueue and exactly one other thread may dequeue at the same time.
+The producer is the only writer of tail and the consumer the only writer of head, so no
+compare-and-swap is needed: a release store publishes new slots and an acquire load on
+the other side makes the slot contents visible before they are read.
+
+head and tail sit on separate cache lines, otherwise every store by one thread would
+invalidate the line the other thread is working on (false sharing). Each side also keeps
+a private cached copy of the other side's index and only reloads the shared index when the
+cached one says the queue is full/empty, which removes most cross-core traffic.
+*/
+typedef struct SpscQueue {
+    int *arr; // buffer, read-only pointer after init
+    unsigned int capacity; // always a power of two
+    unsigned int mask; // capacity - 1
+
+    // producer side
+    _Alignas(CACHE_LINE_SIZE) atomic_uint tail; // counter of next slot to write
+    unsigned int cached_head; // producer's last seen value of head
+
+    // consumer side
+    _Alignas(CACHE_LINE_SIZE) atomic_uint head; // counter of next slot to read
+    unsigned int cached_tail; // consumer's last seen value of tail
+
+    char pad[CACHE_LINE_SIZE - 2 * sizeof(unsigned int)]; // keep the next object off the consumer line
+} SpscQueue;
+
+// method to initialize spsc queue with room for at least capacity elements
+bool init_spsc_queue(SpscQueue *queue, unsigned int capacity) {
+    queue->capacity = round_up_pow2(capacity);
+    if (queue->capacity == 0) {
+        return false;
+    }
+    queue->mask = queue->capacity - 1;
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    queue->cached_head = 0;
+    queue->cached_tail = 0;
+    queue->arr = (int*)malloc(queue->capacity * sizeof(int));
+    return queue->arr != NULL;
+}
+
+// method to free the buffer of an spsc queue (no thread may use it anymore)
+void free_spsc_queue(SpscQueue *queue) {
+    free(queue->arr);
+    queue->arr = NULL;
+}
+
+/*
+method to insert element to spsc queue (producer thread only)
+
+SPSC enqueue:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    The shared head is only loaded when the cached copy says the buffer is full.
+    Returns false if the queue is full, the caller decides whether to retry.
+*/
+bool spsc_enqueue(SpscQueue *queue, int value) {
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    if (tail - queue->cached_head == queue->capacity) {
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        if (tail - queue->cached_head == queue->capacity) {
+            return false;
+        }
+    }
+
+    queue->arr[tail & queue->mask] = value;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release); // publish the slot
+    return true;
+}
+
+/*
+method to remove element from spsc queue (consumer thread only)
+
+SPSC dequeue:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    Mirror of enqueue: the shared tail is only loaded when the cached copy says the
+    buffer is empty. Returns false if the queue is empty.
+*/
+bool spsc_dequeue(SpscQueue *queue, int *value) {
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    if (head == queue->cached_tail) {
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (head == queue->cached_tail) {
+            return false;
+        }
+    }
+
+    *value = queue->arr[head & queue->mask];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release); // hand the slot back
+    return true;
+}
+
+/*
+method to insert up to n elements to spsc queue (producer thread only)
+
+SPSC enqueue n:
+    Time Complexity: O(n)
+    Space Complexity: O(1)
+    All values that fit are copied (at most two memcpy spans) and then published with a
+    single release store, so the consumer sees one cache line transfer per batch instead
+    of one per element. Returns how many values were enqueued.
+*/
+unsigned int spsc_enqueue_n(SpscQueue *queue, const int *values, unsigned int n) {
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    unsigned int free_slots = queue->capacity - (tail - queue->cached_head);
+
+    if (free_slots < n) {
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        free_slots = queue->capacity - (tail - queue->cached_head);
+        if (n > free_slots) {
+            n = free_slots;
+        }
+    }
+
+    unsigned int start = tail & queue->mask;
+    unsigned int first = queue->capacity - start;
+    if (first > n) {
+        first = n;
+    }
+
+    memcpy(queue->arr + start, values, first * sizeof(int));
+    memcpy(queue->arr, values + first, (n - first) * sizeof(int));
+    atomic_store_explicit(&queue->tail, tail + n, memory_order_release);
+    return n;
+}
+
+/*
+method to remove up to n elements from spsc queue (consumer thread only)
+
+SPSC dequeue n:
+    Time Complexity: O(n)
+    Space Complexity: O(1)
+    Copies every available element up to n and frees all of their slots with a single
+    release store. Returns how many values were dequeued.
+*/
+unsigned int spsc_dequeue_n(SpscQueue *queue, int *values, unsigned int n) {
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int available = queue->cached_tail - head;
+
+    if (available < n) {
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        available = queue->cached_tail - head;
+        if (n > available) {
+            n = available;
+        }
+    }
+
+    unsigned int start = head & queue->mask;
+    unsigned int first = queue->capacity - start;
+    if (first > n) {
+        first = n;
+    }
+
+    memcpy(values, queue->arr + start, first * sizeof(int));
+    memcpy(values + first, queue->arr, (n - first) * sizeof(int));
+    atomic_store_explicit(&queue->head, head + n, memory_order_release);
+    return n;
+}
+
+/*
+spsc benchmark
+
+throughput: a producer thread sends count values and a consumer thread receives them,
+            either one at a time or in batches of batch values
+ping: two queues between the threads, the main thread sends a value and waits for it to
+      come back, the round trip time of every ping is recorded for percentiles
+*/
+#define SPSC_BENCH_COUNT (1 << 22)
+#define SPSC_BENCH_PINGS 100000
+#define SPSC_BENCH_BATCH 64
+
+typedef struct SpscBench {
+    SpscQueue *queue; // queue from producer to consumer
+    SpscQueue *reply; // queue back to the producer (ping only)
+    unsigned int count; // number of values to send
+    unsigned int batch; // values per batch call, 1 for single element calls
+    long long checksum; // sum of received values, to check nothing was lost
+} SpscBench;
+
+static void *spsc_bench_producer(void *arg) {
+    SpscBench *bench = (SpscBench*)arg;
+    int values[SPSC_BENCH_BATCH];
+    unsigned int spins = 0;
+
+    for (unsigned int sent = 0; sent < bench->count; ) {
+        if (bench->batch == 1) {
+            if (spsc_enqueue(bench->queue, (int)sent)) {
+                sent++;
+                spins = 0;
+            }
+            else {
+                spin_wait(&spins);
+            }
+            continue;
+        }
+
+        unsigned int n = bench->count - sent < bench->batch ? bench->count - sent : bench->batch;
+        for (unsigned int i = 0; i < n; i++) {
+            values[i] = (int)(sent + i);
+        }
+
+        // the queue may take only part of the batch, send the rest on the next calls
+        unsigned int done = 0;
+        while (done < n) {
+            unsigned int pushed = spsc_enqueue_n(bench->queue, values + done, n - done);
+            if (pushed == 0) {
+                spin_wait(&spins);
+            }
+            else {
+                spins = 0;
+            }
+            done += pushed;
+        }
+        sent += n;
+    }
+    return NULL;
+}
+
+static void *spsc_bench_consumer(void *arg) {
+    SpscBench *bench = (SpscBench*)arg;
+    int values[SPSC_BENCH_BATCH];
+    unsigned int spins = 0;
+
+    for (unsigned int received = 0; received < bench->count; ) {
+        unsigned int n;
+        if (bench->batch == 1) {
+            n = spsc_dequeue(bench->queue, values) ? 1 : 0;
+        }
+        else {
+            n = spsc_dequeue_n(bench->queue, values, bench->batch);
+        }
+
+        if (n == 0) {
+            spin_wait(&spins);
+            continue;
+        }
+
+        spins = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            bench->checksum += values[i];
+        }
+        received += n;
+    }
+    return NULL;
+}
+
+static void *spsc_bench_echo(void *arg) {
+    SpscBench *bench = (SpscBench*)arg;
+    unsigned int spins = 0;
+    int value;
+
+    for (unsigned int i = 0; i < bench->count; i++) {
+        while (!spsc_dequeue(bench->queue, &value)) {
+            spin_wait(&spins);
+        }
+        while (!spsc_enqueue(bench->reply, value)) {
+            spin_wait(&spins);
+        }
+        spins = 0;
+    }
+    return NULL;
+}
+
+static int compare_long_long(const void *a, const void *b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+static void spsc_benchmark_throughput(unsigned int batch) {
+    SpscQueue queue;
+    init_spsc_queue(&queue, 1024);
+
+    SpscBench producer = { &queue, NULL, SPSC_BENCH_COUNT, batch, 0 };
+    SpscBench consumer = producer;
+    pthread_t threads[2];
+
+    long long start = now_ns();
+    pthread_create(&threads[0], NULL, spsc_bench_producer, &producer);
+    pthread_create(&threads[1], NULL, spsc_bench_consumer, &consumer);
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+    long long elapsed = now_ns() - start;
+
+    long long expected = (long long)SPSC_BENCH_COUNT * (SPSC_BENCH_COUNT - 1) / 2;
+    printf("SPSC throughput (batch %2u): %8.2f M ops/sec %s\n", batch,
+        SPSC_BENCH_COUNT / (elapsed / 1e9) / 1e6, consumer.checksum == expected ? "" : "(checksum mismatch)");
+
+    free_spsc_queue(&queue);
+}
+
+static void spsc_benchmark_ping(void) {
+    SpscQueue queue, reply;
+    init_spsc_queue(&queue, 16);
+    init_spsc_queue(&reply, 16);
+
+    SpscBench echo = { &queue, &reply, SPSC_BENCH_PINGS, 1, 0 };
+    long long *latency = (long long*)malloc(SPSC_BENCH_PINGS * sizeof(long long));
+    pthread_t thread;
+    pthread_create(&thread, NULL, spsc_bench_echo, &echo);
+
+    unsigned int spins = 0;
+    int value;
+    for (int i = 0; i < SPSC_BENCH_PINGS; i++) {
+        long long start = now_ns();
+        while (!spsc_enqueue(&queue, i)) {
+            spin_wait(&spins);
+        }
+        while (!spsc_dequeue(&reply, &value)) {
+            spin_wait(&spins);
+        }
+        latency[i] = now_ns() - start;
+        spins = 0;
+    }
+    pthread_join(thread, NULL);
+
+    qsort(latency, SPSC_BENCH_PINGS, sizeof(long long), compare_long_long);
+    printf("SPSC ping round trip: p50 %lld ns, p90 %lld ns, p99 %lld ns, p99.9 %lld ns\n",
+        latency[SPSC_BENCH_PINGS / 2], latency[SPSC_BENCH_PINGS * 9 / 10],
+        latency[SPSC_BENCH_PINGS * 99 / 100], latency[SPSC_BENCH_PINGS * 999 / 1000]);
+
+    free(latency);
+    free_spsc_queue(&queue);
+    free_spsc_queue(&reply);
+}
+
+void spsc_benchmark(void) {
+    printf("\nSPSC queue benchmark (%d values):\n", SPSC_BENCH_COUNT);
+    spsc_benchmark_throughput(1);
+    spsc_benchmark_throughput(SPSC_BENCH_BATCH);
+    spsc_benchmark_ping();
+}
+
+// helper to sleep until *addr is no longer expected (or a wake up arrives)
+static void futex_wait(atomic_uint *addr, unsigned int expected) {
+#ifdef __linux__
+    syscall(SYS_futex, (unsigned int*)addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#else
+    // no futex, callers re-check their condition so yielding is enough to stay correct
+    (void)addr;
+    (void)expected;
+    sched_yield();
+#endif
+}
+
+// helper to wake up to count threads sleeping in futex_wait on addr
+static void futex_wake(atomic_uint *addr, int count) {
+#ifdef __linux__
+    syscall(SYS_futex, (unsigned int*)addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#else
+    (void)addr;
+    (void)count;
+#endif
+}
+
+/*
+multi-producer/multi-consumer bounded queue class (Vyukov array queue)
+
+Any number of threads may enqueue and dequeue at the same time. Every cell carries a
+sequence number that says whose turn it is:
+    sequence == pos          the cell is free for the producer that claims pos
+    sequence == pos + 1      the cell holds the value for the consumer that claims pos
+    sequence == pos + cap    the cell was consumed and is free for the next lap
+A thread claims a position with one compare-and-swap on enqueue_pos/dequeue_pos, then
+owns the cell until it publishes the new sequence with a release store. Producers and
+consumers only contend with their own kind, never on a shared lock.
+
+The blocking variants spin for a short while and then sleep on a futex word. A waiter
+announces itself in the waiter count before re-checking the queue, and the other side
+only makes the wake up system call when that count is non-zero, so the fast path never
+enters the kernel.
+*/
+typedef struct MpmcCell {
+    atomic_uint sequence; // turn marker, see above
+    int value; // stored element
+} MpmcCell;
+
+typedef struct MpmcQueue {
+    MpmcCell *cells; // buffer of capacity cells
+    unsigned int capacity; // always a power of two
+    unsigned int mask; // capacity - 1
+
+    _Alignas(CACHE_LINE_SIZE) atomic_uint enqueue_pos; // next position for producers
+    _Alignas(CACHE_LINE_SIZE) atomic_uint dequeue_pos; // next position for consumers
+
+    _Alignas(CACHE_LINE_SIZE) atomic_uint not_empty; // futex word, bumped when a value arrives
+    atomic_uint empty_waiters; // consumers sleeping or about to sleep on not_empty
+    _Alignas(CACHE_LINE_SIZE) atomic_uint not_full; // futex word, bumped when a cell is freed
+    atomic_uint full_waiters; // producers sleeping or about to sleep on not_full
+
+    char pad[CACHE_LINE_SIZE - 2 * sizeof(atomic_uint)];
+} MpmcQueue;
+
+// method to initialize mpmc queue with room for at least capacity elements
+bool init_mpmc_queue(MpmcQueue *queue, unsigned int capacity) {
+    queue->capacity = round_up_pow2(capacity);
+    if (queue->capacity == 0) {
+        return false;
+    }
+    queue->mask = queue->capacity - 1;
+    queue->cells = (MpmcCell*)malloc(queue->capacity * sizeof(MpmcCell));
+    if (queue->cells == NULL) {
+        return false;
+    }
+
+    // cell i is free for the producer that claims position i
+    for (unsigned int i = 0; i < queue->capacity; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+    }
+
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    atomic_init(&queue->not_empty, 0);
+    atomic_init(&queue->empty_waiters, 0);
+    atomic_init(&queue->not_full, 0);
+    atomic_init(&queue->full_waiters, 0);
+    return true;
+}
+
+// method to free the buffer of an mpmc queue (no thread may use it anymore)
+void free_mpmc_queue(MpmcQueue *queue) {
+    free(queue->cells);
+    queue->cells = NULL;
+}
+
+/*
+method to try to insert element to mpmc queue without blocking
+
+MPMC try enqueue:
+    Time Complexity: O(1) (lock-free, retries only when another producer won the cell)
+    Space Complexity: O(1)
+    Returns false if the queue is full.
+*/
+bool mpmc_try_enqueue(MpmcQueue *queue, int value) {
+    unsigned int pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    MpmcCell *cell;
+
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        unsigned int sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int diff = (int)(sequence - pos);
+
+        if (diff == 0) {
+            // cell is free for pos, try to claim pos
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            return false; // cell still holds a value from the previous lap, queue is full
+        }
+        else {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed); // lost the race
+        }
+    }
+
+    cell->value = value;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release); // hand cell to consumer
+
+    // wake a sleeping consumer, the fence orders the publish before reading the waiter count
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&queue->empty_waiters, memory_order_relaxed) > 0) {
+        atomic_fetch_add(&queue->not_empty, 1);
+        futex_wake(&queue->not_empty, 1);
+    }
+    return true;
+}
+
+/*
+method to try to remove element from mpmc queue without blocking
+
+MPMC try dequeue:
+    Time Complexity: O(1) (lock-free, retries only when another consumer won the cell)
+    Space Complexity: O(1)
+    Returns false if the queue is empty.
+*/
+bool mpmc_try_dequeue(MpmcQueue *queue, int *value) {
+    unsigned int pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    MpmcCell *cell;
+
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        unsigned int sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int diff = (int)(sequence - (pos + 1));
+
+        if (diff == 0) {
+            // cell holds the value for pos, try to claim pos
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            return false; // producer has not filled the cell yet, queue is empty
+        }
+        else {
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    *value = cell->value;
+    // mark the cell free for the producer one lap ahead
+    atomic_store_explicit(&cell->sequence, pos + queue->mask + 1, memory_order_release);
+
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&queue->full_waiters, memory_order_relaxed) > 0) {
+        atomic_fetch_add(&queue->not_full, 1);
+        futex_wake(&queue->not_full, 1);
+    }
+    return true;
+}
+
+/*
+method to insert element to mpmc queue, waiting while it is full
+
+MPMC enqueue:
+    Time Complexity: O(1) when there is room
+    Space Complexity: O(1)
+    Spins for SPIN_LIMIT attempts, then sleeps on not_full. The futex word is read
+    before the final re-check, so a consumer that frees a cell in between changes the
+    word and futex_wait returns immediately instead of missing the wake up.
+*/
+void mpmc_enqueue(MpmcQueue *queue, int value) {
+    for (unsigned int spins = 0; spins < SPIN_LIMIT; spins++) {
+        if (mpmc_try_enqueue(queue, value)) {
+            return;
+        }
+        cpu_relax();
+    }
+
+    for (;;) {
+        atomic_fetch_add(&queue->full_waiters, 1);
+        unsigned int key = atomic_load(&queue->not_full);
+
+        if (mpmc_try_enqueue(queue, value)) {
+            atomic_fetch_sub(&queue->full_waiters, 1);
+            return;
+        }
+
+        futex_wait(&queue->not_full, key);
+        atomic_fetch_sub(&queue->full_waiters, 1);
+
+        if (mpmc_try_enqueue(queue, value)) {
+            return;
+        }
+    }
+}
+
+/*
+method to remove element from mpmc queue, waiting while it is empty
+
+MPMC dequeue:
+    Time Complexity: O(1) when there is a value
+    Space Complexity: O(1)
+    Mirror of mpmc_enqueue, sleeps on not_empty.
+*/
+int mpmc_dequeue(MpmcQueue *queue) {
+    int value;
+
+    for (unsigned int spins = 0; spins < SPIN_LIMIT; spins++) {
+        if (mpmc_try_dequeue(queue, &value)) {
+            return value;
+        }
+        cpu_relax();
+    }
+
+    for (;;) {
+        atomic_fetch_add(&queue->empty_waiters, 1);
+        unsigned int key = atomic_load(&queue->not_empty);
+
+        if (mpmc_try_dequeue(queue, &value)) {
+            atomic_fetch_sub(&queue->empty_waiters, 1);
+            return value;
+        }
+
+        futex_wait(&queue->not_empty, key);
+        atomic_fetch_sub(&queue->empty_waiters, 1);
+
+        if (mpmc_try_dequeue(queue, &value)) {
+            return value;
+        }
+    }
+}
+
+/*
+mpmc benchmark
+
+producers and consumers use the blocking calls on a small queue so both the full and the
+empty path are hit. The total number of values is the same for every ratio.
+*/
+#define MPMC_BENCH_COUNT (1 << 20)
+#define MPMC_BENCH_MAX_THREADS 8
+
+typedef struct MpmcBench {
+    MpmcQueue *queue;
+    unsigned int count; // values this thread sends or receives
+    long long checksum; // sum of received values
+} MpmcBench;
+
+static void *mpmc_bench_producer(void *arg) {
+    MpmcBench *bench = (MpmcBench*)arg;
+    for (unsigned int i = 0; i < bench->count; i++) {
+        mpmc_enqueue(bench->queue, (int)i);
+    }
+    return NULL;
+}
+
+static void *mpmc_bench_consumer(void *arg) {
+    MpmcBench *bench = (MpmcBench*)arg;
+    for (unsigned int i = 0; i < bench->count; i++) {
+        bench->checksum += mpmc_dequeue(bench->queue);
+    }
+    return NULL;
+}
+
+static void mpmc_benchmark_ratio(int producers, int consumers) {
+    MpmcQueue queue;
+    init_mpmc_queue(&queue, 256);
+
+    MpmcBench benches[MPMC_BENCH_MAX_THREADS];
+    pthread_t threads[MPMC_BENCH_MAX_THREADS];
+
+    long long start = now_ns();
+    for (int i = 0; i < producers + consumers; i++) {
+        benches[i].queue = &queue;
+        benches[i].checksum = 0;
+        if (i < producers) {
+            benches[i].count = MPMC_BENCH_COUNT / producers;
+            pthread_create(&threads[i], NULL, mpmc_bench_producer, &benches[i]);
+        }
+        else {
+            benches[i].count = MPMC_BENCH_COUNT / consumers;
+            pthread_create(&threads[i], NULL, mpmc_bench_consumer, &benches[i]);
+        }
+    }
+
+    long long checksum = 0;
+    long long expected = 0;
+    for (int i = 0; i < producers + consumers; i++) {
+        pthread_join(threads[i], NULL);
+        if (i < producers) {
+            expected += (long long)benches[i].count * (benches[i].count - 1) / 2;
+        }
+        else {
+            checksum += benches[i].checksum;
+        }
+    }
+    long long elapsed = now_ns() - start;
+
+    printf("MPMC %d producers : %d consumers: %8.2f M ops/sec %s\n", producers, consumers,
+        MPMC_BENCH_COUNT / (elapsed / 1e9) / 1e6, checksum == expected ? "" : "(checksum mismatch)");
+
+    free_mpmc_queue(&queue);
+}
+
+void mpmc_benchmark(void) {
+    printf("\nMPMC queue benchmark (%d values):\n", MPMC_BENCH_COUNT);
+    mpmc_benchmark_ratio(1, 1);
+    mpmc_benchmark_ratio(1, 4);
+    mpmc_benchmark_ratio(4, 1);
+    mpmc_benchmark_ratio(2, 2);
+    mpmc_benchmark_ratio(4, 4);
+}
+
+/*
+helpers for an implicit d-ary min heap stored in an int array
+
+the children of index i are arity * i + 1 ... arity * i + arity and its parent is
+(i - 1) / arity. With arity 4 the heap is half as deep as a binary heap, and the four
+children are next to each other in memory (one cache line for 16 ints), so a sift down
+costs fewer cache misses even though it compares more children per level.
+Both helpers move a "hole" instead of swapping, which saves one write per level.
+arity is a constant at every call site, so the compiler turns the division into a shift.
+*/
+static inline void heap_sift_up(int *heap, int i, int arity) {
+    int value = heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / arity;
+        if (heap[parent] <= value) {
+            break;
+        }
+        heap[i] = heap[parent]; // move parent down into the hole
+        i = parent;
+    }
+    heap[i] = value;
+}
+
+static inline void heap_sift_down(int *heap, int size, int i, int arity) {
+    int value = heap[i];
+    for (;;) {
+        int first = arity * i + 1;
+        if (first >= size) {
+            break;
+        }
+
+        // find the smallest child
+        int last = first + arity < size ? first + arity : size;
+        int smallest = first;
+        for (int c = first + 1; c < last; c++) {
+            if (heap[c] < heap[smallest]) {
+                smallest = c;
+            }
+        }
+
+        if (value <= heap[smallest]) {
+            break;
+        }
+        heap[i] = heap[smallest]; // move child up into the hole
+        i = smallest;
+    }
+    heap[i] = value;
+}
+
+// priority queue class (min heap with PQ_ARITY children per node)
+typedef struct PriorityQueue {
+    int *heap; // implicit heap, smallest value at index 0
+    int size; // number of elements
+    int capacity; // allocated elements
+} PriorityQueue;
+
+// method to initialize priority queue
+bool init_priority_queue(PriorityQueue *pq, int capacity) {
+    pq->capacity = capacity > 0 ? capacity : 1;
+    pq->size = 0;
+    pq->heap = (int*)malloc(pq->capacity * sizeof(int));
+    return pq->heap != NULL;
+}
+
+// method to free priority queue
+void free_priority_queue(PriorityQueue *pq) {
+    free(pq->heap);
+    pq->heap = NULL;
+    pq->size = 0;
+    pq->capacity = 0;
+}
+
+/*
+method to insert element to priority queue
+
+Push:
+    Time Complexity: O(log n) (Amortized, base PQ_ARITY)
+    Space Complexity: O(1) (Amortized)
+    The value is placed at the end and sifted up. Capacity doubles when full.
+*/
+bool pq_push(PriorityQueue *pq, int value) {
+    if (pq->size == pq->capacity) {
+        int *heap = (int*)realloc(pq->heap, 2 * pq->capacity * sizeof(int));
+        if (heap == NULL) {
+            return false;
+        }
+        pq->heap = heap;
+        pq->capacity *= 2;
+    }
+
+    pq->heap[pq->size] = value;
+    heap_sift_up(pq->heap, pq->size, PQ_ARITY);
+    pq->size++;
+    return true;
+}
+
+/*
+method to remove smallest element from priority queue
+
+Pop min:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    The last element replaces the root and is sifted down. Returns false if empty.
+*/
+bool pq_pop(PriorityQueue *pq, int *value) {
+    if (pq->size == 0) {
+        return false;
+    }
+
+    *value = pq->heap[0];
+    pq->size--;
+    if (pq->size > 0) {
+        pq->heap[0] = pq->heap[pq->size];
+        heap_sift_down(pq->heap, pq->size, 0, PQ_ARITY);
+    }
+    return true;
+}
+
+// method to return smallest element of priority queue without removing it
+bool pq_peek(PriorityQueue *pq, int *value) {
+    if (pq->size == 0) {
+        return false;
+    }
+
+    *value = pq->heap[0];
+    return true;
+}
+
+/*
+method to replace the contents of priority queue with the elements of an array
+
+Heapify:
+    Time Complexity: O(n)
+    Space Complexity: O(n)
+    The array is copied as is and then every parent is sifted down, starting from the
+    last one. Most nodes are near the bottom and only move a level or two, so the total
+    work is linear, cheaper than n separate pushes at O(n log n).
+*/
+bool pq_heapify(PriorityQueue *pq, Array arr) {
+    if (arr.size > pq->capacity) {
+        int *heap = (int*)realloc(pq->heap, arr.size * sizeof(int));
+        if (heap == NULL) {
+            return false;
+        }
+        pq->heap = heap;
+        pq->capacity = arr.size;
+    }
+
+    memcpy(pq->heap, arr.data, arr.size * sizeof(int));
+    pq->size = arr.size;
+
+    for (int i = (pq->size - 2) / PQ_ARITY; i >= 0; i--) {
+        heap_sift_down(pq->heap, pq->size, i, PQ_ARITY);
+    }
+    return true;
+}
+
+// method to display priority queue in heap (array) order
+void display_priority_queue(PriorityQueue *pq) {
+    if (pq->size == 0) {
+        printf("\nPriority queue is empty.\n");
+        return;
+    }
+
+    printf("\nPriority Queue (%d): [", pq->size);
+    for (int i = 0; i < pq->size; i++) {
+        printf("%d%s", pq->heap[i], i < pq->size - 1 ? ", " : "");
+    }
+    printf("]\n");
+}
+
+/*
+indexed priority queue class
+
+Elements are handles 0 ... max_handles - 1 (for example graph vertices) each with an
+int key. position remembers where every handle is in the heap, which is what makes
+decrease_key possible: the handle is found in O(1) and sifted up from there.
+*/
+typedef struct IndexedPriorityQueue {
+    int *heap; // handles, ordered by their keys
+    int *position; // heap index of every handle, -1 if not in the queue
+    int *keys; // key of every handle
+    int size; // number of handles in the queue
+    int max_handles; // handles must be smaller than this
+} IndexedPriorityQueue;
+
+// method to initialize indexed priority queue for handles 0 ... max_handles - 1
+bool init_indexed_priority_queue(IndexedPriorityQueue *pq, int max_handles) {
+    pq->heap = (int*)malloc(max_handles * sizeof(int));
+    pq->position = (int*)malloc(max_handles * sizeof(int));
+    pq->keys = (int*)malloc(max_handles * sizeof(int));
+    pq->size = 0;
+    pq->max_handles = max_handles;
+
+    if (pq->heap == NULL || pq->position == NULL || pq->keys == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < max_handles; i++) {
+        pq->position[i] = -1;
+    }
+    return true;
+}
+
+// method to free indexed priority queue
+void free_indexed_priority_queue(IndexedPriorityQueue *pq) {
+    free(pq->heap);
+    free(pq->position);
+    free(pq->keys);
+    pq->heap = NULL;
+    pq->position = NULL;
+    pq->keys = NULL;
+    pq->size = 0;
+}
+
+// method to check if handle is in the indexed priority queue
+bool ipq_contains(IndexedPriorityQueue *pq, int handle) {
+    return handle >= 0 && handle < pq->max_handles && pq->position[handle] != -1;
+}
+
+// helpers to sift a handle, same as heap_sift_up/down but comparing keys and updating position
+static void ipq_sift_up(IndexedPriorityQueue *pq, int i) {
+    int handle = pq->heap[i];
+    int key = pq->keys[handle];
+
+    while (i > 0) {
+        int parent = (i - 1) / PQ_ARITY;
+        if (pq->keys[pq->heap[parent]] <= key) {
+            break;
+        }
+        pq->heap[i] = pq->heap[parent];
+        pq->position[pq->heap[i]] = i;
+        i = parent;
+    }
+    pq->heap[i] = handle;
+    pq->position[handle] = i;
+}
+
+static void ipq_sift_down(IndexedPriorityQueue *pq, int i) {
+    int handle = pq->heap[i];
+    int key = pq->keys[handle];
+
+    for (;;) {
+        int first = PQ_ARITY * i + 1;
+        if (first >= pq->size) {
+            break;
+        }
+
+        int last = first + PQ_ARITY < pq->size ? first + PQ_ARITY : pq->size;
+        int smallest = first;
+        for (int c = first + 1; c < last; c++) {
+            if (pq->keys[pq->heap[c]] < pq->keys[pq->heap[smallest]]) {
+                smallest = c;
+            }
+        }
+
+        if (key <= pq->keys[pq->heap[smallest]]) {
+            break;
+        }
+        pq->heap[i] = pq->heap[smallest];
+        pq->position[pq->heap[i]] = i;
+        i = smallest;
+    }
+    pq->heap[i] = handle;
+    pq->position[handle] = i;
+}
+
+/*
+method to insert handle with key to indexed priority queue
+
+IPQ push:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    Returns false if the handle is out of range or already in the queue.
+*/
+bool ipq_push(IndexedPriorityQueue *pq, int handle, int key) {
+    if (handle < 0 || handle >= pq->max_handles || pq->position[handle] != -1) {
+        return false;
+    }
+
+    pq->keys[handle] = key;
+    pq->heap[pq->size] = handle;
+    pq->size++;
+    ipq_sift_up(pq, pq->size - 1);
+    return true;
+}
+
+/*
+method to remove handle with smallest key from indexed priority queue
+
+IPQ pop:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    Returns false if empty.
+*/
+bool ipq_pop(IndexedPriorityQueue *pq, int *handle, int *key) {
+    if (pq->size == 0) {
+        return false;
+    }
+
+    *handle = pq->heap[0];
+    *key = pq->keys[*handle];
+    pq->position[*handle] = -1;
+    pq->size--;
+
+    if (pq->size > 0) {
+        pq->heap[0] = pq->heap[pq->size];
+        ipq_sift_down(pq, 0);
+    }
+    return true;
+}
+
+/*
+method to lower the key of a handle in the indexed priority queue
+
+Decrease key:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    A smaller key can only move the handle towards the root, so one sift up is enough.
+    Returns false if the handle is not in the queue or key is not smaller.
+*/
+bool ipq_decrease_key(IndexedPriorityQueue *pq, int handle, int key) {
+    if (!ipq_contains(pq, handle) || key >= pq->keys[handle]) {
+        return false;
+    }
+
+    pq->keys[handle] = key;
+    ipq_sift_up(pq, pq->position[handle]);
+    return true;
+}
+
+/*
+priority queue benchmark, PQ_ARITY-ary heap against a binary heap
+
+pop heavy: heapify n random values and pop all of them
+push heavy: push n random values, popping once after every fourth push
+*/
+#define PQ_BENCH_COUNT (1 << 20)
+
+static long long pq_bench_pop_heavy(const int *values, int *heap, int arity) {
+    long long start = now_ns();
+    long long sum = 0;
+    int size = PQ_BENCH_COUNT;
+
+    memcpy(heap, values, size * sizeof(int));
+    for (int i = (size - 2) / arity; i >= 0; i--) {
+        if (arity == 2) {
+            heap_sift_down(heap, size, i, 2);
+        }
+        else {
+            heap_sift_down(heap, size, i, PQ_ARITY);
+        }
+    }
+
+    while (size > 0) {
+        sum += heap[0];
+        heap[0] = heap[--size];
+        if (arity == 2) {
+            heap_sift_down(heap, size, 0, 2);
+        }
+        else {
+            heap_sift_down(heap, size, 0, PQ_ARITY);
+        }
+    }
+
+    if (sum == 42) {
+        printf(" "); // keep the compiler from dropping the loop
+    }
+    return now_ns() - start;
+}
+
+static long long pq_bench_push_heavy(const int *values, int *heap, int arity) {
+    long long start = now_ns();
+    int size = 0;
+
+    for (int i = 0; i < PQ_BENCH_COUNT; i++) {
+        heap[size] = values[i];
+        if (arity == 2) {
+            heap_sift_up(heap, size, 2);
+        }
+        else {
+            heap_sift_up(heap, size, PQ_ARITY);
+        }
+        size++;
+
+        if ((i & 3) == 3) {
+            heap[0] = heap[--size];
+            if (arity == 2) {
+                heap_sift_down(heap, size, 0, 2);
+            }
+            else {
+                heap_sift_down(heap, size, 0, PQ_ARITY);
+            }
+        }
+    }
+    return now_ns() - start;
+}
+
+void pq_benchmark(void) {
+    int *values = (int*)malloc(PQ_BENCH_COUNT * sizeof(int));
+    int *heap = (int*)malloc(PQ_BENCH_COUNT * sizeof(int));
+    srand(1);
+    for (int i = 0; i < PQ_BENCH_COUNT; i++) {
+        values[i] = rand();
+    }
+
+    printf("\nPriority queue benchmark (%d values):\n", PQ_BENCH_COUNT);
+    printf("pop heavy:  binary heap %7.2f ms, %d-ary heap %7.2f ms\n",
+        pq_bench_pop_heavy(values, heap, 2) / 1e6, PQ_ARITY, pq_bench_pop_heavy(values, heap, PQ_ARITY) / 1e6);
+    printf("push heavy: binary heap %7.2f ms, %d-ary heap %7.2f ms\n",
+        pq_bench_push_heavy(values, heap, 2) / 1e6, PQ_ARITY, pq_bench_push_heavy(values, heap, PQ_ARITY) / 1e6);
+
+    free(values);
+    free(heap);
+}
+
+/*
+work-stealing deque class (Chase-Lev)
+
+One owner thread pushes and pops at the bottom, any number of thief threads steal from
+the top. The owner's push/pop need no compare-and-swap: only when a single element is
+left can the owner race with a thief, and then both settle it with a CAS on top. Thieves
+always CAS on top, so two thieves never get the same element.
+
+The buffer is a circular array that the owner grows when it is full. Thieves may still
+be reading the old array, so it is not freed right away but kept on a retired list until
+the deque itself is freed (the arrays double, so together they are less than the final one).
+Memory orders follow Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+Work-Stealing for Weak Memory Models" (PPoPP 2013).
+*/
+typedef struct WsArray {
+    long capacity; // always a power of two
+    struct WsArray *retired; // previous (smaller) array, freed with the deque
+    _Atomic(void*) slots[]; // element of index i is in slots[i & (capacity - 1)]
+} WsArray;
+
+typedef struct WsDeque {
+    _Alignas(CACHE_LINE_SIZE) atomic_long top; // next index to steal, only grows
+    _Alignas(CACHE_LINE_SIZE) atomic_long bottom; // next index to push, owner only
+    _Atomic(WsArray*) array; // current buffer
+    char pad[CACHE_LINE_SIZE - sizeof(atomic_long) - sizeof(void*)];
+} WsDeque;
+
+static WsArray *ws_array_create(long capacity) {
+    WsArray *array = (WsArray*)malloc(sizeof(WsArray) + capacity * sizeof(_Atomic(void*)));
+    if (array != NULL) {
+        array->capacity = capacity;
+        array->retired = NULL;
+    }
+    return array;
+}
+
+// method to initialize work-stealing deque
+bool init_ws_deque(WsDeque *deque) {
+    WsArray *array = ws_array_create(WS_MIN_CAPACITY);
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, array);
+    return array != NULL;
+}
+
+// method to free work-stealing deque and all its retired arrays (no thread may use it anymore)
+void free_ws_deque(WsDeque *deque) {
+    WsArray *array = atomic_load(&deque->array);
+    while (array != NULL) {
+        WsArray *retired = array->retired;
+        free(array);
+        array = retired;
+    }
+    atomic_store(&deque->array, NULL);
+}
+
+// method to return (an estimate of) the number of elements in work-stealing deque
+long ws_size(WsDeque *deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    return bottom > top ? bottom - top : 0;
+}
+
+// helper to double the buffer, copying the elements from top to bottom (owner only)
+static WsArray *ws_grow(WsDeque *deque, WsArray *array, long top, long bottom) {
+    WsArray *bigger = ws_array_create(array->capacity * 2);
+    if (bigger == NULL) {
+        return NULL;
+    }
+
+    for (long i = top; i < bottom; i++) {
+        void *item = atomic_load_explicit(&array->slots[i & (array->capacity - 1)], memory_order_relaxed);
+        atomic_store_explicit(&bigger->slots[i & (bigger->capacity - 1)], item, memory_order_relaxed);
+    }
+
+    bigger->retired = array;
+    atomic_store_explicit(&deque->array, bigger, memory_order_release);
+    return bigger;
+}
+
+/*
+method to push element to bottom of work-stealing deque (owner only)
+
+WS push:
+    Time Complexity: O(1) (Amortized)
+    Space Complexity: O(1) (Amortized)
+    bottom is published with a release store, so a thief that sees the new bottom also
+    sees the element (and everything the owner wrote into it before the push).
+*/
+bool ws_push(WsDeque *deque, void *item) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    WsArray *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    if (bottom - top > array->capacity - 1) {
+        array = ws_grow(deque, array, top, bottom);
+        if (array == NULL) {
+            return false;
+        }
+    }
+
+    atomic_store_explicit(&array->slots[bottom & (array->capacity - 1)], item, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+    return true;
+}
+
+/*
+method to pop element from bottom of work-stealing deque (owner only)
+
+WS pop:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    bottom is lowered first and the seq_cst fence orders that before reading top, so a
+    thief either sees the lowered bottom or the owner sees the thief's new top. Only for
+    the last element both can succeed, which the CAS on top decides.
+    Returns NULL if the deque is empty.
+*/
+void *ws_pop(WsDeque *deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    WsArray *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        // deque was empty, undo
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    void *item = atomic_load_explicit(&array->slots[bottom & (array->capacity - 1)], memory_order_relaxed);
+    if (top == bottom) {
+        // last element, race thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                memory_order_seq_cst, memory_order_relaxed)) {
+            item = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+/*
+method to steal element from top of work-stealing deque (any thread)
+
+WS steal:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    Returns NULL if the deque is empty or another thread won the element, the caller
+    simply tries another victim.
+*/
+void *ws_steal(WsDeque *deque) {
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    if (top >= bottom) {
+        return NULL;
+    }
+
+    WsArray *array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    void *item = atomic_load_explicit(&array->slots[top & (array->capacity - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+            memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return item;
+}
+
+/*
+fork-join thread pool class
+
+Every worker owns a work-stealing deque, and deque 0 belongs to the thread that calls
+parallel_for. A thread first pops its own deque (newest task, still hot in cache) and
+only steals from the top of a random other deque (oldest task, usually the biggest
+piece of work) when it runs out. Idle workers spin for a while and then sleep on a
+futex word that is bumped whenever a task is pushed while someone is sleeping, using the
+same waiter count protocol as MpmcQueue.
+*/
+typedef void (*RangeBody)(void *context, long begin, long end);
+
+typedef struct ParallelForJob {
+    RangeBody body; // called on every leaf range
+    void *context; // passed to body
+    long grain; // ranges of at most this many iterations are not split further
+    atomic_long pending; // ranges not finished yet
+} ParallelForJob;
+
+typedef struct RangeTask {
+    ParallelForJob *job;
+    long begin;
+    long end;
+} RangeTask;
+
+typedef struct ThreadPool {
+    int thread_count; // worker threads, not counting the caller of parallel_for
+    pthread_t threads[POOL_MAX_THREADS];
+    WsDeque deques[POOL_MAX_THREADS + 1]; // deque 0 is the caller's
+    atomic_bool stop; // set by free_thread_pool
+    _Alignas(CACHE_LINE_SIZE) atomic_uint work_available; // futex word, bumped on push with sleepers
+    atomic_uint sleepers; // workers sleeping or about to sleep on work_available
+} ThreadPool;
+
+typedef struct PoolWorker {
+    ThreadPool *pool;
+    int index; // deque index of this worker
+} PoolWorker;
+
+// a deque has one owner, so the index only counts in the pool it belongs to
+static _Thread_local ThreadPool *pool_worker_pool = NULL; // pool the current thread works for, NULL outside workers
+static _Thread_local int pool_worker_index = 0; // deque of the current thread in pool_worker_pool
+
+// helper to steal one task from any deque except the current thread's own
+static void *pool_steal(ThreadPool *pool, int self, unsigned int *seed) {
+    int victims = pool->thread_count + 1;
+    *seed = *seed * 1103515245u + 12345u;
+    int start = (int)((*seed >> 16) % (unsigned int)victims);
+
+    for (int i = 0; i < victims; i++) {
+        int victim = (start + i) % victims;
+        if (victim == self) {
+            continue;
+        }
+        void *task = ws_steal(&pool->deques[victim]);
+        if (task != NULL) {
+            return task;
+        }
+    }
+    return NULL;
+}
+
+// helper to check if any deque has tasks, used before going to sleep
+static bool pool_has_work(ThreadPool *pool) {
+    for (int i = 0; i <= pool->thread_count; i++) {
+        if (ws_size(&pool->deques[i]) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// helper to wake one sleeping worker after a push
+static void pool_notify(ThreadPool *pool) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&pool->sleepers, memory_order_relaxed) > 0) {
+        atomic_fetch_add(&pool->work_available, 1);
+        futex_wake(&pool->work_available, 1);
+    }
+}
+
+/*
+helper to run a range task
+
+The range is split in half until it is no bigger than grain. The right halves are
+pushed to the own deque where idle threads can steal them, and the thread keeps going
+with the left half. Ranges nobody steals are popped again by the same thread later.
+*/
+static void pool_run_task(ThreadPool *pool, WsDeque *own, RangeTask *task) {
+    ParallelForJob *job = task->job;
+    long begin = task->begin;
+    long end = task->end;
+    free(task);
+
+    while (end - begin > job->grain) {
+        long middle = begin + (end - begin) / 2;
+        RangeTask *right = (RangeTask*)malloc(sizeof(RangeTask));
+        if (right == NULL) {
+            break; // out of memory, run the whole range here
+        }
+
+        // fill in and count the task before it becomes visible to thieves
+        right->job = job;
+        right->begin = middle;
+        right->end = end;
+        atomic_fetch_add(&job->pending, 1);
+        if (!ws_push(own, right)) {
+            free(right);
+            atomic_fetch_sub(&job->pending, 1);
+            break;
+        }
+        pool_notify(pool);
+        end = middle;
+    }
+
+    job->body(job->context, begin, end);
+    atomic_fetch_sub_explicit(&job->pending, 1, memory_order_release);
+}
+
+static void *pool_worker_main(void *arg) {
+    PoolWorker *worker = (PoolWorker*)arg;
+    ThreadPool *pool = worker->pool;
+    int self = worker->index;
+    WsDeque *own = &pool->deques[self];
+    unsigned int seed = (unsigned int)self * 2654435761u;
+    free(worker);
+
+    pool_worker_pool = pool;
+    pool_worker_index = self;
+
+    while (!atomic_load_explicit(&pool->stop, memory_order_acquire)) {
+        RangeTask *task = (RangeTask*)ws_pop(own);
+        if (task == NULL) {
+            task = (RangeTask*)pool_steal(pool, self, &seed);
+        }
+        if (task != NULL) {
+            pool_run_task(pool, own, task);
+            continue;
+        }
+
+        // nothing to do: spin a little, then sleep until a push or stop
+        bool found = false;
+        for (int spins = 0; spins < SPIN_LIMIT && !found; spins++) {
+            cpu_relax();
+            found = pool_has_work(pool);
+        }
+        if (found) {
+            continue;
+        }
+
+        atomic_fetch_add(&pool->sleepers, 1);
+        unsigned int key = atomic_load(&pool->work_available);
+        if (!pool_has_work(pool) && !atomic_load(&pool->stop)) {
+            futex_wait(&pool->work_available, key);
+        }
+        atomic_fetch_sub(&pool->sleepers, 1);
+    }
+    return NULL;
+}
+
+// helper to stop and join the first started workers of a pool
+static void pool_stop_workers(ThreadPool *pool, int started) {
+    atomic_store(&pool->stop, true);
+    atomic_fetch_add(&pool->work_available, 1);
+    futex_wake(&pool->work_available, POOL_MAX_THREADS);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+
+/*
+method to start a thread pool with thread_count worker threads
+
+returns false if a deque, a worker or its thread can't be created, every deque and
+worker made so far is released again and the pool must not be used
+*/
+bool init_thread_pool(ThreadPool *pool, int thread_count) {
+    if (thread_count < 0 || thread_count > POOL_MAX_THREADS) {
+        return false;
+    }
+
+    pool->thread_count = thread_count;
+    atomic_init(&pool->stop, false);
+    atomic_init(&pool->work_available, 0);
+    atomic_init(&pool->sleepers, 0);
+
+    for (int i = 0; i <= thread_count; i++) {
+        if (!init_ws_deque(&pool->deques[i])) {
+            for (int j = 0; j <= i; j++) {
+                free_ws_deque(&pool->deques[j]);
+            }
+            return false;
+        }
+    }
+
+    for (int i = 0; i < thread_count; i++) {
+        PoolWorker *worker = (PoolWorker*)malloc(sizeof(PoolWorker));
+        if (worker != NULL) {
+            worker->pool = pool;
+            worker->index = i + 1;
+        }
+
+        if (worker == NULL || pthread_create(&pool->threads[i], NULL, pool_worker_main, worker) != 0) {
+            free(worker);
+
+            // the started workers may be stealing from any deque, stop them before freeing
+            pool_stop_workers(pool, i);
+            for (int j = 0; j <= thread_count; j++) {
+                free_ws_deque(&pool->deques[j]);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+// method to stop the workers and free a thread pool
+void free_thread_pool(ThreadPool *pool) {
+    pool_stop_workers(pool, pool->thread_count);
+
+    for (int i = 0; i <= pool->thread_count; i++) {
+        free_ws_deque(&pool->deques[i]);
+    }
+}
+
+/*
+method to run body over [begin, end) in parallel
+
+Parallel for:
+    Time Complexity: O(n / p + log n) for p threads
+    Space Complexity: O(log n) tasks per thread at a time
+    body is called on disjoint ranges of at most grain iterations that together cover
+    [begin, end). The calling thread works too, and while it waits for stolen ranges to
+    finish it keeps stealing, so parallel_for may also be called from inside a body.
+    Only one thread outside the pool may call parallel_for on a pool at the same time,
+    a worker of another pool counts as outside and submits through deque 0 too.
+*/
+void parallel_for(ThreadPool *pool, long begin, long end, long grain, RangeBody body, void *context) {
+    if (begin >= end) {
+        return;
+    }
+
+    ParallelForJob job;
+    job.body = body;
+    job.context = context;
+    job.grain = grain > 0 ? grain : 1;
+    atomic_init(&job.pending, 1);
+
+    RangeTask *root = (RangeTask*)malloc(sizeof(RangeTask));
+    if (root == NULL) {
+        body(context, begin, end);
+        return;
+    }
+    root->job = &job;
+    root->begin = begin;
+    root->end = end;
+
+    int self = pool_worker_pool == pool ? pool_worker_index : 0;
+    WsDeque *own = &pool->deques[self];
+    unsigned int seed = (unsigned int)(uintptr_t)&job;
+    pool_run_task(pool, own, root);
+
+    // help until every range of this job is done, tasks of other jobs may be run too
+    unsigned int spins = 0;
+    while (atomic_load_explicit(&job.pending, memory_order_acquire) > 0) {
+        RangeTask *task = (RangeTask*)ws_pop(own);
+        if (task == NULL) {
+            task = (RangeTask*)pool_steal(pool, self, &seed);
+        }
+
+        if (task != NULL) {
+            pool_run_task(pool, own, task);
+            spins = 0;
+        }
+        else {
+            spin_wait(&spins);
+        }
+    }
+}
+
+/*
+thread pool benchmark
+
+sums f(i) over a range with 1, 2 and 4 workers plus the caller:
+fine-grained: cheap f and grain 256, so scheduling overhead matters
+coarse-grained: expensive f and few large ranges
+*/
+#define POOL_BENCH_FINE_COUNT (1L << 24)
+#define POOL_BENCH_COARSE_COUNT (1L << 16)
+
+typedef struct PoolBenchSum {
+    atomic_llong total;
+} PoolBenchSum;
+
+static void pool_bench_fine_body(void *context, long begin, long end) {
+    PoolBenchSum *sum = (PoolBenchSum*)context;
+    long long local = 0;
+    for (long i = begin; i < end; i++) {
+        local += i ^ (i >> 3);
+    }
+    atomic_fetch_add_explicit(&sum->total, local, memory_order_relaxed);
+}
+
+static void pool_bench_coarse_body(void *context, long begin, long end) {
+    PoolBenchSum *sum = (PoolBenchSum*)context;
+    long long local = 0;
+    for (long i = begin; i < end; i++) {
+        unsigned long long x = (unsigned long long)i;
+        for (int round = 0; round < 200; round++) {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        local += (long long)(x >> 40);
+    }
+    atomic_fetch_add_explicit(&sum->total, local, memory_order_relaxed);
+}
+
+void pool_benchmark(void) {
+    printf("\nThread pool parallel_for benchmark:\n");
+
+    long long fine_expected = 0;
+    long long coarse_expected = 0;
+    for (int threads = 0; threads <= 4; threads = threads == 0 ? 1 : threads * 2) {
+        ThreadPool *pool = (ThreadPool*)malloc(sizeof(ThreadPool));
+        if (pool == NULL || !init_thread_pool(pool, threads)) {
+            printf("caller + %d workers: can't start pool\n", threads);
+            free(pool);
+            continue;
+        }
+
+        PoolBenchSum fine, coarse;
+        atomic_init(&fine.total, 0);
+        atomic_init(&coarse.total, 0);
+
+        long long start = now_ns();
+        parallel_for(pool, 0, POOL_BENCH_FINE_COUNT, 256, pool_bench_fine_body, &fine);
+        long long fine_time = now_ns() - start;
+
+        start = now_ns();
+        parallel_for(pool, 0, POOL_BENCH_COARSE_COUNT, POOL_BENCH_COARSE_COUNT / 16, pool_bench_coarse_body, &coarse);
+        long long coarse_time = now_ns() - start;
+
+        if (threads == 0) {
+            fine_expected = atomic_load(&fine.total);
+            coarse_expected = atomic_load(&coarse.total);
+        }
+        bool correct = atomic_load(&fine.total) == fine_expected && atomic_load(&coarse.total) == coarse_expected;
+
+        printf("caller + %d workers: fine-grained %7.2f ms, coarse-grained %7.2f ms %s\n", threads,
+            fine_time / 1e6, coarse_time / 1e6, correct ? "" : "(sum mismatch)");
+
+        free_thread_pool(pool);
+        free(pool);
+    }
+}
+
+// main
+int main(int argc, char* argv[]) {
+    Queue queue;
+    init_queue(&queue);
+    display_queue(&queue);
+
+    enqueue(&queue, 5);
+    enqueue(&queue, 10);
+    enqueue(&queue, 20);
+    enqueue(&queue, 40);
+    enqueue(&queue, 80);
+    enqueue(&queue, 160);
+    enqueue(&queue, 320);
+    enqueue(&queue, 640);
+    enqueue(&queue, 1280);
+    enqueue(&queue, 2560);
+    
+    display_queue(&queue);
+    
+    dequeue(&queue);
+    dequeue(&queue);
+    dequeue(&queue);
+    dequeue(&queue);
+    dequeue(&queue);
+
+    display_queue(&queue);
+
+    peek(&queue);
+
+    RingQueue ring;
+    init_ring_queue(&ring, 4);
+
+    // far more lifetime enqueues than the capacity, the ring never reports full
+    for (int i = 0; i < 100; i++) {
+        int value;
+        ring_enqueue(&ring, i);
+        ring_dequeue(&ring, &value);
+    }
+    display_ring_queue(&ring);
+
+    int values[40];
+    for (int i = 0; i < 40; i++) {
+        values[i] = i * 5;
+    }
+    ring_enqueue_n(&ring, values, 12);
+    display_ring_queue(&ring);
+
+    ring_enqueue_n(&ring, values + 12, 28); // wraps and grows the buffer
+    display_ring_queue(&ring);
+
+    int out[40];
+    unsigned int count = ring_dequeue_n(&ring, out, 30);
+    printf("\nDequeued %u elements, first %d last %d.\n", count, out[0], out[count - 1]);
+    display_ring_queue(&ring);
+
+    free_ring_queue(&ring);
+
+    PriorityQueue pq;
+    init_priority_queue(&pq, 4);
+    Array arr = { values, 10 };
+    pq_heapify(&pq, arr);
+    pq_push(&pq, 7);
+    pq_push(&pq, 3);
+    display_priority_queue(&pq);
+
+    int smallest;
+    while (pq_pop(&pq, &smallest)) {
+        printf("%d ", smallest);
+    }
+    printf("\n");
+    free_priority_queue(&pq);
+
+    IndexedPriorityQueue ipq;
+    init_indexed_priority_queue(&ipq, 4);
+    ipq_push(&ipq, 0, 50);
+    ipq_push(&ipq, 1, 20);
+    ipq_push(&ipq, 2, 40);
+    ipq_decrease_key(&ipq, 2, 10);
+
+    int handle, key;
+    while (ipq_pop(&ipq, &handle, &key)) {
+        printf("\nHandle %d with key %d.", handle, key);
+    }
+    printf("\n");
+    free_indexed_priority_queue(&ipq);
+
+    // benchmarks only run when asked for: ./queue bench
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        spsc_benchmark();
+        mpmc_benchmark();
+        pq_benchmark();
+        pool_benchmark();
+    }
 
     return 0;
 }
@@ -1,7 +1,21 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 #define MAX_SIZE 10
+#define SEGMENT_SIZE 1024 // elements per segment of the segmented stack
+#define CACHE_LINE_SIZE 64 // bytes, used to keep data of different threads apart
+#define TREIBER_NIL 0u // packed index of "no node"
+#define ELIMINATION_SLOTS 8 // exchange slots used when the head is contended
+#define ELIMINATION_SPINS 64 // how long a push offer waits for a pop to take it
 
 // stack class
 typedef struct Stack {
@@ -125,7 +139,931 @@ int peek(Stack *stack) {
     }
     
     // return top element of stack without removing it
-    return printf("\nTop of stack: %d\n", stack->arr[stack->top]);
+    printf("\nTop of stack: %d\n", stack->arr[stack->top]);
+    return stack->arr[stack->top];
+}
+
+/*
+segmented stack class
+
+Stack above is limited to MAX_SIZE elements. SegmentedStack grows without limit by
+chaining fixed size segments: only the top segment is written, and a full segment
+is never copied (unlike a realloc'ed array, which moves everything on every growth).
+
+When the top segment becomes empty it is not freed right away but kept as a spare.
+Otherwise push/pop oscillating right at a segment boundary would malloc and free
+a segment on every single call.
+*/
+typedef struct Segment {
+    int arr[SEGMENT_SIZE]; // elements of this segment
+    struct Segment *prev; // segment below this one
+} Segment;
+
+typedef struct SegmentedStack {
+    Segment *segment; // top segment, NULL before the first push
+    int top; // number of elements used in the top segment
+    Segment *spare; // at most one cached empty segment
+    long size; // total number of elements
+} SegmentedStack;
+
+// method to initialize segmented stack
+void init_segmented_stack(SegmentedStack *stack) {
+    stack->segment = NULL;
+    stack->top = 0;
+    stack->spare = NULL;
+    stack->size = 0;
+}
+
+// method to free all segments of a segmented stack
+void free_segmented_stack(SegmentedStack *stack) {
+    while (stack->segment != NULL) {
+        Segment *prev = stack->segment->prev;
+        free(stack->segment);
+        stack->segment = prev;
+    }
+    free(stack->spare);
+    init_segmented_stack(stack);
+}
+
+// method to check if segmented stack is empty
+bool seg_is_empty(SegmentedStack *stack) {
+    return stack->size == 0;
+}
+
+// helper to put a new empty segment on top, reusing the spare if there is one
+static bool seg_add_segment(SegmentedStack *stack) {
+    Segment *segment = stack->spare;
+
+    if (segment != NULL) {
+        stack->spare = NULL;
+    }
+    else {
+        segment = (Segment*)malloc(sizeof(Segment));
+        if (segment == NULL) {
+            return false;
+        }
+    }
+
+    segment->prev = stack->segment;
+    stack->segment = segment;
+    stack->top = 0;
+    return true;
+}
+
+// helper to drop the empty top segment, keeping it as the spare
+static void seg_remove_segment(SegmentedStack *stack) {
+    Segment *segment = stack->segment;
+    stack->segment = segment->prev;
+    stack->top = SEGMENT_SIZE; // every segment below the top is full
+
+    free(stack->spare); // keep only one spare so memory can shrink again
+    stack->spare = segment;
+}
+
+// helper to make sure the next push can't fail, by allocating the spare segment it would need
+static bool seg_reserve(SegmentedStack *stack) {
+    if ((stack->segment != NULL && stack->top < SEGMENT_SIZE) || stack->spare != NULL) {
+        return true;
+    }
+    stack->spare = (Segment*)malloc(sizeof(Segment));
+    return stack->spare != NULL;
+}
+
+// helper to empty a segmented stack, the bottom segment and a spare stay for the next pushes
+static void seg_clear(SegmentedStack *stack) {
+    while (stack->segment != NULL && stack->segment->prev != NULL) {
+        seg_remove_segment(stack);
+    }
+    stack->top = 0;
+    stack->size = 0;
+}
+
+/*
+method to push element to top of segmented stack
+
+Seg push:
+    Time Complexity: O(1)
+    Space Complexity: O(1) (Amortized)
+    Writes into the top segment. Once every SEGMENT_SIZE pushes a segment is added,
+    taken from the spare when possible. Returns false only if malloc fails.
+*/
+bool seg_push(SegmentedStack *stack, int value) {
+    if ((stack->segment == NULL || stack->top == SEGMENT_SIZE) && !seg_add_segment(stack)) {
+        return false;
+    }
+
+    stack->segment->arr[stack->top++] = value;
+    stack->size++;
+    return true;
+}
+
+/*
+method to pop element from top of segmented stack
+
+Seg pop:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    When the top segment runs empty it becomes the spare and the full segment below
+    becomes the top. Returns false if the stack is empty.
+*/
+bool seg_pop(SegmentedStack *stack, int *value) {
+    if (stack->size == 0) {
+        return false;
+    }
+
+    *value = stack->segment->arr[--stack->top];
+    stack->size--;
+
+    if (stack->top == 0 && stack->segment->prev != NULL) {
+        seg_remove_segment(stack);
+    }
+    return true;
+}
+
+// method to return top element of segmented stack without removing it
+bool seg_peek(SegmentedStack *stack, int *value) {
+    if (stack->size == 0) {
+        return false;
+    }
+
+    *value = stack->segment->arr[stack->top - 1];
+    return true;
+}
+
+/*
+method to push n elements to segmented stack
+
+Seg push n:
+    Time Complexity: O(n)
+    Space Complexity: O(n)
+    Values are copied with one memcpy per segment they land in. values[n - 1] ends up
+    on top, the same as n calls to seg_push.
+*/
+bool seg_push_n(SegmentedStack *stack, const int *values, int n) {
+    while (n > 0) {
+        if ((stack->segment == NULL || stack->top == SEGMENT_SIZE) && !seg_add_segment(stack)) {
+            return false;
+        }
+
+        int count = SEGMENT_SIZE - stack->top;
+        if (count > n) {
+            count = n;
+        }
+
+        memcpy(stack->segment->arr + stack->top, values, count * sizeof(int));
+        stack->top += count;
+        stack->size += count;
+        values += count;
+        n -= count;
+    }
+    return true;
+}
+
+/*
+method to pop up to n elements from segmented stack
+
+Seg pop n:
+    Time Complexity: O(n)
+    Space Complexity: O(1)
+    The popped elements are written in the order they were pushed (the old top is
+    values[count - 1]), so seg_pop_n undoes seg_push_n and every segment is copied
+    with a single memcpy. Returns how many elements were popped.
+*/
+int seg_pop_n(SegmentedStack *stack, int *values, int n) {
+    if (n > stack->size) {
+        n = (int)stack->size;
+    }
+
+    // fill values from the back, the top segment holds the last elements
+    int remaining = n;
+    while (remaining > 0) {
+        int count = stack->top < remaining ? stack->top : remaining;
+
+        stack->top -= count;
+        stack->size -= count;
+        remaining -= count;
+        memcpy(values + remaining, stack->segment->arr + stack->top, count * sizeof(int));
+
+        if (stack->top == 0 && stack->segment->prev != NULL) {
+            seg_remove_segment(stack);
+        }
+    }
+    return n;
+}
+
+// method to display size and top element of segmented stack
+void display_segmented_stack(SegmentedStack *stack) {
+    int top;
+    if (!seg_peek(stack, &top)) {
+        printf("\nSegmented stack is empty.\n");
+        return;
+    }
+
+    printf("\nSegmented Stack (%ld), top: %d\n", stack->size, top);
+}
+
+// helper to tell the cpu we are busy-waiting
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+// helper to read a monotonic clock in nanoseconds
+static inline long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+lock-free stack class (Treiber stack)
+
+The stack links nodes of a node array by index, so it can be used as a free list for an
+object pool: a node is owned by whoever popped it until it is pushed again, and several
+stacks may share one node array (e.g. "free" and "in use").
+
+head packs the top node and a tag into one 64 bit word:
+    low 32 bits   index of the top node + 1 (TREIBER_NIL when empty)
+    high 32 bits  tag, incremented by every successful push and pop
+Without the tag a pop could suffer from ABA: thread 1 reads top A and next B, thread 2
+pops A and B and pushes A back, and thread 1's compare-and-swap still sees A and sets
+the top to B, a node that is no longer on the stack. With the tag the word has changed
+even though the index is the same, so the stale compare-and-swap fails. A 64 bit CAS is
+lock-free on every common platform, unlike a 128 bit pointer+tag CAS.
+
+Under heavy contention most compare-and-swaps on head fail. A failing push then offers
+its node in a random elimination slot for a short time, and a failing pop looks for
+such an offer. A matched push/pop pair completes without touching head at all.
+*/
+typedef struct TreiberNode {
+    atomic_uint next; // packed index of the node below (only meaningful while on a stack)
+    int value; // payload, written by the owner of the node
+} TreiberNode;
+
+typedef struct TreiberStack {
+    TreiberNode *nodes; // node array the stack links, may be shared
+    _Alignas(CACHE_LINE_SIZE) atomic_ullong head; // tag << 32 | packed index of top node
+    _Alignas(CACHE_LINE_SIZE) atomic_uint elimination[ELIMINATION_SLOTS]; // packed node offers
+} TreiberStack;
+
+static inline unsigned int treiber_index(unsigned long long head) {
+    return (unsigned int)(head & 0xFFFFFFFFu);
+}
+
+static inline unsigned long long treiber_pack(unsigned long long old_head, unsigned int index) {
+    return ((old_head >> 32) + 1) << 32 | index; // bump the tag of the old head
+}
+
+// helper for a cheap per-thread random number, picks an elimination slot
+static unsigned int elimination_slot(void) {
+    static _Thread_local unsigned int seed = 0;
+    if (seed == 0) {
+        seed = (unsigned int)(uintptr_t)&seed | 1; // differs between threads
+    }
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed % ELIMINATION_SLOTS;
+}
+
+// method to initialize an empty lock-free stack over a node array
+void init_treiber_stack(TreiberStack *stack, TreiberNode *nodes) {
+    stack->nodes = nodes;
+    atomic_init(&stack->head, TREIBER_NIL);
+    for (int i = 0; i < ELIMINATION_SLOTS; i++) {
+        atomic_init(&stack->elimination[i], TREIBER_NIL);
+    }
+}
+
+// helper for a push that lost the race on head, returns true if a pop took the node
+static bool treiber_offer(TreiberStack *stack, unsigned int packed) {
+    atomic_uint *slot = &stack->elimination[elimination_slot()];
+    unsigned int expected = TREIBER_NIL;
+
+    if (!atomic_compare_exchange_strong(slot, &expected, packed)) {
+        return false; // slot busy, go back to head
+    }
+
+    for (int spins = 0; spins < ELIMINATION_SPINS; spins++) {
+        if (atomic_load_explicit(slot, memory_order_acquire) != packed) {
+            return true; // a pop cleared the slot and owns the node now
+        }
+        cpu_relax();
+    }
+
+    // withdraw the offer, failing means a pop took it in the meantime
+    expected = packed;
+    return !atomic_compare_exchange_strong(slot, &expected, TREIBER_NIL);
+}
+
+// helper for a pop that lost the race on head, returns a node index or -1
+static int treiber_take_offer(TreiberStack *stack) {
+    atomic_uint *slot = &stack->elimination[elimination_slot()];
+    unsigned int packed = atomic_load_explicit(slot, memory_order_acquire);
+
+    if (packed != TREIBER_NIL && atomic_compare_exchange_strong(slot, &packed, TREIBER_NIL)) {
+        return (int)packed - 1;
+    }
+    return -1;
+}
+
+/*
+method to push node to lock-free stack
+
+Treiber push:
+    Time Complexity: O(1) (lock-free, retries only while other threads succeed)
+    Space Complexity: O(1)
+    Links the node on top of the current head and publishes it with a release CAS, so
+    a thread that pops the node also sees the value written before the push.
+*/
+void treiber_push(TreiberStack *stack, int index) {
+    unsigned int packed = (unsigned int)index + 1;
+    unsigned long long head = atomic_load_explicit(&stack->head, memory_order_relaxed);
+
+    for (;;) {
+        atomic_store_explicit(&stack->nodes[index].next, treiber_index(head), memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(&stack->head, &head, treiber_pack(head, packed),
+                memory_order_release, memory_order_relaxed)) {
+            return;
+        }
+
+        if (treiber_offer(stack, packed)) {
+            return;
+        }
+        head = atomic_load_explicit(&stack->head, memory_order_relaxed);
+    }
+}
+
+/*
+method to push a pre-linked chain of nodes to lock-free stack
+
+Treiber push chain:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    The caller links first ... last through next (packed indices, see treiber_link).
+    Only last is pointed at the old head, so the whole chain is published with a single
+    CAS no matter how long it is. first ends up on top.
+*/
+void treiber_push_chain(TreiberStack *stack, int first, int last) {
+    unsigned long long head = atomic_load_explicit(&stack->head, memory_order_relaxed);
+
+    for (;;) {
+        atomic_store_explicit(&stack->nodes[last].next, treiber_index(head), memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(&stack->head, &head, treiber_pack(head, (unsigned int)first + 1),
+                memory_order_release, memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+// method to link node index below node above, used to build a chain for treiber_push_chain
+void treiber_link(TreiberNode *nodes, int above, int index) {
+    atomic_store_explicit(&nodes[above].next, (unsigned int)index + 1, memory_order_relaxed);
+}
+
+/*
+method to pop node from lock-free stack
+
+Treiber pop:
+    Time Complexity: O(1) (lock-free)
+    Space Complexity: O(1)
+    Reads the top node and its next, then swings head to next with a CAS that also
+    bumps the tag. Returns the node index, or -1 if the stack is empty.
+*/
+int treiber_pop(TreiberStack *stack) {
+    unsigned long long head = atomic_load_explicit(&stack->head, memory_order_acquire);
+
+    for (;;) {
+        unsigned int top = treiber_index(head);
+        if (top == TREIBER_NIL) {
+            return -1;
+        }
+
+        /*
+        the node may be popped and reused by another thread while we read next, then
+        next is stale but the tag has changed and the CAS below fails
+        */
+        unsigned int next = atomic_load_explicit(&stack->nodes[top - 1].next, memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(&stack->head, &head, treiber_pack(head, next),
+                memory_order_acquire, memory_order_acquire)) {
+            return (int)top - 1;
+        }
+
+        int index = treiber_take_offer(stack);
+        if (index >= 0) {
+            return index;
+        }
+        head = atomic_load_explicit(&stack->head, memory_order_acquire);
+    }
+}
+
+/*
+Treiber stack stress test
+
+every node has an owner flag. A thread that pops a node sets the flag and a thread that
+pushes it clears it, so if a node were ever handed to two threads at once (the ABA
+problem) the flag would already be set. Threads also push back chains of several nodes
+to exercise treiber_push_chain. At the end every node must be on the stack exactly once.
+*/
+#define TREIBER_TEST_NODES 64
+#define TREIBER_TEST_THREADS 4
+#define TREIBER_TEST_ROUNDS 200000
+#define TREIBER_CHAIN_LENGTH 4
+
+typedef struct TreiberTest {
+    TreiberStack *stack;
+    atomic_int *owned; // owner flag of every node
+    atomic_int *errors; // number of double owned nodes seen
+} TreiberTest;
+
+static void *treiber_test_thread(void *arg) {
+    TreiberTest *test = (TreiberTest*)arg;
+    int chain[TREIBER_CHAIN_LENGTH];
+
+    for (int round = 0; round < TREIBER_TEST_ROUNDS; round++) {
+        int count = 0;
+        int wanted = (round & 7) == 0 ? TREIBER_CHAIN_LENGTH : 1;
+
+        while (count < wanted) {
+            int index = treiber_pop(test->stack);
+            if (index < 0) {
+                break;
+            }
+            if (atomic_exchange(&test->owned[index], 1) != 0) {
+                atomic_fetch_add(test->errors, 1);
+            }
+            chain[count++] = index;
+        }
+
+        for (int i = 0; i < count; i++) {
+            atomic_store(&test->owned[chain[i]], 0);
+        }
+
+        if (count == 1) {
+            treiber_push(test->stack, chain[0]);
+        }
+        else if (count > 1) {
+            for (int i = 0; i + 1 < count; i++) {
+                treiber_link(test->stack->nodes, chain[i], chain[i + 1]);
+            }
+            treiber_push_chain(test->stack, chain[0], chain[count - 1]);
+        }
+    }
+    return NULL;
+}
+
+bool treiber_stress_test(void) {
+    TreiberNode nodes[TREIBER_TEST_NODES];
+    atomic_int owned[TREIBER_TEST_NODES];
+    atomic_int errors;
+    static TreiberStack stack;
+
+    init_treiber_stack(&stack, nodes);
+    atomic_init(&errors, 0);
+    for (int i = 0; i < TREIBER_TEST_NODES; i++) {
+        atomic_init(&owned[i], 0);
+        treiber_push(&stack, i);
+    }
+
+    TreiberTest test = { &stack, owned, &errors };
+    pthread_t threads[TREIBER_TEST_THREADS];
+    for (int i = 0; i < TREIBER_TEST_THREADS; i++) {
+        pthread_create(&threads[i], NULL, treiber_test_thread, &test);
+    }
+    for (int i = 0; i < TREIBER_TEST_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // drain the stack, every node must come out exactly once
+    int seen[TREIBER_TEST_NODES] = { 0 };
+    int count = 0;
+    int index;
+    while ((index = treiber_pop(&stack)) >= 0) {
+        if (seen[index]++ != 0) {
+            atomic_fetch_add(&errors, 1);
+        }
+        count++;
+    }
+
+    bool passed = atomic_load(&errors) == 0 && count == TREIBER_TEST_NODES;
+    printf("\nTreiber stack stress test (%d threads): %s (%d nodes, %d errors)\n",
+        TREIBER_TEST_THREADS, passed ? "passed" : "FAILED", count, atomic_load(&errors));
+    return passed;
+}
+
+/*
+Treiber stack benchmark against Stack guarded by a mutex
+
+every thread does push/pop pairs on one shared stack. The locked version uses the same
+array update as push and pop above, only without the printing.
+*/
+#define STACK_BENCH_OPS 1000000
+#define STACK_BENCH_MAX_THREADS 8
+
+typedef struct StackBench {
+    TreiberStack *treiber;
+    Stack *locked;
+    pthread_mutex_t *mutex;
+    int ops; // push/pop pairs of this thread
+} StackBench;
+
+static void *stack_bench_treiber(void *arg) {
+    StackBench *bench = (StackBench*)arg;
+    for (int i = 0; i < bench->ops; i++) {
+        int index = treiber_pop(bench->treiber);
+        if (index >= 0) {
+            bench->treiber->nodes[index].value = i;
+            treiber_push(bench->treiber, index);
+        }
+    }
+    return NULL;
+}
+
+static void *stack_bench_locked(void *arg) {
+    StackBench *bench = (StackBench*)arg;
+    for (int i = 0; i < bench->ops; i++) {
+        pthread_mutex_lock(bench->mutex);
+        if (!is_full(bench->locked)) {
+            bench->locked->arr[++bench->locked->top] = i;
+        }
+        pthread_mutex_unlock(bench->mutex);
+
+        pthread_mutex_lock(bench->mutex);
+        if (!is_empty(bench->locked)) {
+            bench->locked->top--;
+        }
+        pthread_mutex_unlock(bench->mutex);
+    }
+    return NULL;
+}
+
+static long long stack_bench_run(int thread_count, bool lock_free) {
+    static TreiberStack treiber;
+    TreiberNode nodes[STACK_BENCH_MAX_THREADS];
+    Stack locked;
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    init_treiber_stack(&treiber, nodes);
+    for (int i = 0; i < STACK_BENCH_MAX_THREADS; i++) {
+        treiber_push(&treiber, i);
+    }
+    init_stack(&locked);
+
+    StackBench bench = { &treiber, &locked, &mutex, STACK_BENCH_OPS / thread_count };
+    pthread_t threads[STACK_BENCH_MAX_THREADS];
+
+    long long start = now_ns();
+    for (int i = 0; i < thread_count; i++) {
+        pthread_create(&threads[i], NULL, lock_free ? stack_bench_treiber : stack_bench_locked, &bench);
+    }
+    for (int i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return now_ns() - start;
+}
+
+void stack_benchmark(void) {
+    printf("\nStack benchmark (%d push/pop pairs):\n", STACK_BENCH_OPS);
+    for (int threads = 1; threads <= STACK_BENCH_MAX_THREADS; threads *= 2) {
+        long long locked = stack_bench_run(threads, false);
+        long long lock_free = stack_bench_run(threads, true);
+        printf("%d threads: mutex Stack %7.2f M pairs/sec, Treiber stack %7.2f M pairs/sec\n", threads,
+            STACK_BENCH_OPS / (locked / 1e9) / 1e6, STACK_BENCH_OPS / (lock_free / 1e9) / 1e6);
+    }
+}
+
+/*
+min/max stack class
+
+Next to every value the stack also stores the minimum and maximum of everything at or
+below it. The answer for the whole stack is therefore always the entry on top, and
+popping automatically restores the answer of the smaller stack. The three columns are
+segmented stacks so the stack is unbounded.
+*/
+typedef struct MinMaxStack {
+    SegmentedStack values; // pushed values
+    SegmentedStack mins; // minimum of each value and everything below it
+    SegmentedStack maxs; // maximum of each value and everything below it
+} MinMaxStack;
+
+// method to initialize min/max stack
+void init_min_max_stack(MinMaxStack *stack) {
+    init_segmented_stack(&stack->values);
+    init_segmented_stack(&stack->mins);
+    init_segmented_stack(&stack->maxs);
+}
+
+// method to free min/max stack
+void free_min_max_stack(MinMaxStack *stack) {
+    free_segmented_stack(&stack->values);
+    free_segmented_stack(&stack->mins);
+    free_segmented_stack(&stack->maxs);
+}
+
+/*
+method to push element to min/max stack
+
+Min/max push:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    The new minimum/maximum only depends on the value and the previous top entry.
+    Room is reserved in all three columns before anything is pushed, so when malloc
+    fails the stack is left as it was and false is returned.
+*/
+bool min_max_push(MinMaxStack *stack, int value) {
+    int min = value;
+    int max = value;
+    int below;
+
+    if (seg_peek(&stack->mins, &below) && below < min) {
+        min = below;
+    }
+    if (seg_peek(&stack->maxs, &below) && below > max) {
+        max = below;
+    }
+
+    if (!seg_reserve(&stack->values) || !seg_reserve(&stack->mins) || !seg_reserve(&stack->maxs)) {
+        return false;
+    }
+    seg_push(&stack->values, value);
+    seg_push(&stack->mins, min);
+    seg_push(&stack->maxs, max);
+    return true;
+}
+
+// method to pop element from min/max stack, O(1)
+bool min_max_pop(MinMaxStack *stack, int *value) {
+    int unused;
+    return seg_pop(&stack->values, value) && seg_pop(&stack->mins, &unused) && seg_pop(&stack->maxs, &unused);
+}
+
+// method to return smallest element of min/max stack, O(1)
+bool min_max_min(MinMaxStack *stack, int *min) {
+    return seg_peek(&stack->mins, min);
+}
+
+// method to return largest element of min/max stack, O(1)
+bool min_max_max(MinMaxStack *stack, int *max) {
+    return seg_peek(&stack->maxs, max);
+}
+
+// associative operations for aggregate stacks and sliding windows
+typedef int (*AggregateOp)(int, int);
+
+int aggregate_min(int a, int b) {
+    return a < b ? a : b;
+}
+
+int aggregate_max(int a, int b) {
+    return a > b ? a : b;
+}
+
+int aggregate_sum(int a, int b) {
+    return a + b;
+}
+
+/*
+aggregate stack class
+
+Same idea as MinMaxStack for any associative operation. The op does not have to be
+commutative, so the order matters: normally the aggregate is op(below, value), i.e. the
+older elements are on the left. With newest_below set the aggregate is op(value, below),
+which is needed for the front half of a sliding window where the top is the oldest.
+*/
+typedef struct AggregateStack {
+    SegmentedStack values; // pushed values
+    SegmentedStack aggregates; // op over each value and everything below it
+    AggregateOp op; // associative operation
+    bool newest_below; // true if elements below the top are newer than the top
+} AggregateStack;
+
+// method to initialize aggregate stack
+void init_aggregate_stack(AggregateStack *stack, AggregateOp op, bool newest_below) {
+    init_segmented_stack(&stack->values);
+    init_segmented_stack(&stack->aggregates);
+    stack->op = op;
+    stack->newest_below = newest_below;
+}
+
+// method to free aggregate stack
+void free_aggregate_stack(AggregateStack *stack) {
+    free_segmented_stack(&stack->values);
+    free_segmented_stack(&stack->aggregates);
+}
+
+// helper to make sure the next aggregate_push can't fail
+static bool aggregate_reserve(AggregateStack *stack) {
+    return seg_reserve(&stack->values) && seg_reserve(&stack->aggregates);
+}
+
+// method to push element to aggregate stack, O(1), false and unchanged if malloc fails
+bool aggregate_push(AggregateStack *stack, int value) {
+    int aggregate = value;
+    int below;
+
+    if (seg_peek(&stack->aggregates, &below)) {
+        aggregate = stack->newest_below ? stack->op(value, below) : stack->op(below, value);
+    }
+
+    if (!aggregate_reserve(stack)) {
+        return false;
+    }
+    seg_push(&stack->values, value);
+    seg_push(&stack->aggregates, aggregate);
+    return true;
+}
+
+// method to pop element from aggregate stack, O(1)
+bool aggregate_pop(AggregateStack *stack, int *value) {
+    int unused;
+    return seg_pop(&stack->values, value) && seg_pop(&stack->aggregates, &unused);
+}
+
+// method to return op over all elements of aggregate stack, O(1)
+bool aggregate_query(AggregateStack *stack, int *aggregate) {
+    return seg_peek(&stack->aggregates, aggregate);
+}
+
+/*
+sliding window class (queue made of two aggregate stacks)
+
+New values are pushed on back. Old values are popped from front, and when front is
+empty all of back is moved over, which reverses the order so the oldest value ends up
+on top of front. The window aggregate is op(front aggregate, back aggregate): front holds
+the older part of the window and back the newer part.
+*/
+typedef struct SlidingWindow {
+    AggregateStack front; // older elements, oldest on top
+    AggregateStack back; // newer elements, newest on top
+    long size; // elements currently in the window
+    long capacity; // window length, older elements are dropped
+} SlidingWindow;
+
+// method to initialize sliding window of capacity elements, false if capacity isn't positive
+bool init_sliding_window(SlidingWindow *window, long capacity, AggregateOp op) {
+    init_aggregate_stack(&window->front, op, true);
+    init_aggregate_stack(&window->back, op, false);
+    window->size = 0;
+    window->capacity = capacity;
+    return capacity > 0;
+}
+
+// method to free sliding window
+void free_sliding_window(SlidingWindow *window) {
+    free_aggregate_stack(&window->front);
+    free_aggregate_stack(&window->back);
+}
+
+/*
+helper to move all of back onto the empty front, oldest on top
+
+back is read from top to bottom without popping, so if a push onto front fails, front
+is emptied again and the window is left as it was. Afterwards back is cleared but keeps
+its bottom segment, so a push reserved on back before the transfer still can't fail.
+*/
+static bool window_transfer(SlidingWindow *window) {
+    SegmentedStack *values = &window->back.values;
+    int count = values->top;
+
+    for (Segment *segment = values->segment; segment != NULL; segment = segment->prev) {
+        for (int i = count - 1; i >= 0; i--) {
+            if (!aggregate_push(&window->front, segment->arr[i])) {
+                seg_clear(&window->front.values);
+                seg_clear(&window->front.aggregates);
+                return false;
+            }
+        }
+        count = SEGMENT_SIZE; // every segment below the top is full
+    }
+
+    seg_clear(&window->back.values);
+    seg_clear(&window->back.aggregates);
+    return true;
+}
+
+/*
+method to remove oldest element from sliding window
+
+Window pop:
+    Time Complexity: O(1) (Amortized)
+    Space Complexity: O(1)
+    A transfer costs O(k) for k elements, but every element is transferred at most once
+    in its lifetime, so each element pays O(1) for it. Returns false if the window is
+    empty or malloc fails during a transfer, the window is unchanged then.
+*/
+bool window_pop(SlidingWindow *window, int *value) {
+    if (window->size == 0) {
+        return false;
+    }
+
+    if (seg_is_empty(&window->front.values) && !window_transfer(window)) {
+        return false;
+    }
+
+    window->size--;
+    return aggregate_pop(&window->front, value);
+}
+
+/*
+method to add element to sliding window, dropping the oldest element once it is full
+
+Window push:
+    Time Complexity: O(1) (Amortized)
+    Space Complexity: O(1)
+    Everything that can fail (room on back, dropping the oldest element) happens before
+    the push, so if malloc fails false is returned and the window is unchanged.
+*/
+bool window_push(SlidingWindow *window, int value) {
+    if (!aggregate_reserve(&window->back)) {
+        return false;
+    }
+    if (window->size == window->capacity) {
+        int dropped;
+        if (!window_pop(window, &dropped)) {
+            return false;
+        }
+    }
+
+    aggregate_push(&window->back, value); // reserved above, can't fail
+    window->size++;
+    return true;
+}
+
+/*
+method to return op over all elements in sliding window
+
+Window query:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+*/
+bool window_query(SlidingWindow *window, int *aggregate) {
+    int front, back;
+    bool has_front = aggregate_query(&window->front, &front);
+    bool has_back = aggregate_query(&window->back, &back);
+
+    if (has_front && has_back) {
+        *aggregate = window->front.op(front, back);
+    }
+    else if (has_front) {
+        *aggregate = front;
+    }
+    else if (has_back) {
+        *aggregate = back;
+    }
+    return has_front || has_back;
+}
+
+/*
+sliding window benchmark
+
+rolling minimum over a random stream, once with SlidingWindow and once by rescanning the
+last window values after every new value (O(window) per value)
+*/
+#define WINDOW_BENCH_COUNT 200000
+
+void window_benchmark(void) {
+    int *stream = (int*)malloc(WINDOW_BENCH_COUNT * sizeof(int));
+    srand(1);
+    for (int i = 0; i < WINDOW_BENCH_COUNT; i++) {
+        stream[i] = rand();
+    }
+
+    printf("\nSliding window minimum benchmark (%d values):\n", WINDOW_BENCH_COUNT);
+    for (int size = 8; size <= 4096; size *= 8) {
+        long long checksum_naive = 0;
+        long long checksum_window = 0;
+
+        long long start = now_ns();
+        for (int i = 0; i < WINDOW_BENCH_COUNT; i++) {
+            int first = i - size + 1 > 0 ? i - size + 1 : 0;
+            int min = stream[first];
+            for (int j = first + 1; j <= i; j++) {
+                if (stream[j] < min) {
+                    min = stream[j];
+                }
+            }
+            checksum_naive += min;
+        }
+        long long naive = now_ns() - start;
+
+        SlidingWindow window;
+        bool pushed = init_sliding_window(&window, size, aggregate_min);
+        start = now_ns();
+        for (int i = 0; i < WINDOW_BENCH_COUNT && pushed; i++) {
+            int min;
+            pushed = window_push(&window, stream[i]);
+            window_query(&window, &min);
+            checksum_window += min;
+        }
+        long long two_stack = now_ns() - start;
+        free_sliding_window(&window);
+
+        printf("window %4d: rescan %8.2f ms, two-stack window %6.2f ms %s\n", size, naive / 1e6,
+            two_stack / 1e6, pushed && checksum_naive == checksum_window ? "" : "(mismatch)");
+    }
+
+    free(stream);
 }
 
 int main(int argc, char* argv[]) {
@@ -175,5 +1113,67 @@ int main(int argc, char* argv[]) {
 
     peek(&stack);
 
+    SegmentedStack segmented;
+    init_segmented_stack(&segmented);
+    display_segmented_stack(&segmented);
+
+    // far beyond MAX_SIZE, spans many segments
+    for (int i = 0; i < 5000; i++) {
+        seg_push(&segmented, i);
+    }
+    display_segmented_stack(&segmented);
+
+    int values[4000];
+    for (int i = 0; i < 3000; i++) {
+        values[i] = -i;
+    }
+    seg_push_n(&segmented, values, 3000);
+    display_segmented_stack(&segmented);
+
+    int popped = seg_pop_n(&segmented, values, 4000);
+    printf("\nPopped %d elements, oldest %d newest %d.\n", popped, values[0], values[popped - 1]);
+    display_segmented_stack(&segmented);
+
+    free_segmented_stack(&segmented);
+
+    MinMaxStack min_max;
+    init_min_max_stack(&min_max);
+    min_max_push(&min_max, 5);
+    min_max_push(&min_max, 2);
+    min_max_push(&min_max, 9);
+
+    int min, max;
+    min_max_min(&min_max, &min);
+    min_max_max(&min_max, &max);
+    printf("\nMin/max stack: min %d, max %d\n", min, max);
+
+    min_max_pop(&min_max, &popped);
+    min_max_pop(&min_max, &popped);
+    min_max_min(&min_max, &min);
+    min_max_max(&min_max, &max);
+    printf("\nMin/max stack after two pops: min %d, max %d\n", min, max);
+    free_min_max_stack(&min_max);
+
+    SlidingWindow window;
+    init_sliding_window(&window, 3, aggregate_sum);
+    int stream[] = { 1, 2, 3, 4, 5, 6 };
+    for (int i = 0; i < 6; i++) {
+        int sum;
+        window_push(&window, stream[i]);
+        window_query(&window, &sum);
+        printf("\nSum of last 3 values after %d: %d", stream[i], sum);
+    }
+    printf("\n");
+    free_sliding_window(&window);
+
+    // stress test and benchmarks only run when asked for: ./stack test, ./stack bench
+    if (argc > 1 && strcmp(argv[1], "test") == 0) {
+        return treiber_stress_test() ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        stack_benchmark();
+        window_benchmark();
+    }
+
     return 0;
 }
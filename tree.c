@@ -0,0 +1,1670 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define CACHE_LINE_SIZE 64
+#define BTREE_LEAF_KEYS 15 // keys per leaf, header + keys fill two cache lines
+#define BTREE_INNER_KEYS 15 // keys per inner node, header + keys fill two cache lines and 16 children two more
+#define BTREE_LEAF_MIN (BTREE_LEAF_KEYS / 2) // fewest keys in a leaf other than the root
+#define BTREE_INNER_MIN (BTREE_INNER_KEYS / 2) // fewest keys in an inner node other than the root
+#define ART_MAX_PREFIX 10 // compressed path bytes stored in a node, longer paths are checked at the leaf
+
+// helper to read a monotonic clock in nanoseconds
+static inline long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+B+tree ordered map class (int64 keys and values)
+
+All key/value pairs are stored in the leaves, and the leaves are linked left to right,
+so a range scan finds its first key once and then just walks the leaf chain. Inner nodes
+only hold separator keys: children[i] holds the keys k with keys[i - 1] <= k < keys[i].
+
+Nodes are allocated on cache line boundaries and the 8-byte header plus 15 keys are
+exactly two lines, with values (or children) in separate arrays after them, so a search
+inside a node reads exactly two cache lines. The search itself
+counts the keys that are smaller instead of branching on each comparison. That loop has a
+fixed trip count and no data dependent branches, so the compiler turns it into SIMD
+compares and there are no branch mispredictions on random keys.
+*/
+typedef struct BTreeNode {
+    int count; // number of keys
+    bool is_leaf;
+} BTreeNode;
+
+typedef struct BTreeLeaf {
+    BTreeNode header;
+    int64_t keys[BTREE_LEAF_KEYS];
+    int64_t values[BTREE_LEAF_KEYS];
+    struct BTreeLeaf *next; // leaf to the right, NULL for the last leaf
+} BTreeLeaf;
+
+typedef struct BTreeInner {
+    BTreeNode header;
+    int64_t keys[BTREE_INNER_KEYS];
+    BTreeNode *children[BTREE_INNER_KEYS + 1];
+} BTreeInner;
+
+_Static_assert(offsetof(BTreeLeaf, values) == 2 * CACHE_LINE_SIZE && sizeof(BTreeLeaf) % CACHE_LINE_SIZE == 0,
+    "leaf header + keys must fill two cache lines");
+_Static_assert(offsetof(BTreeInner, children) == 2 * CACHE_LINE_SIZE && sizeof(BTreeInner) % CACHE_LINE_SIZE == 0,
+    "inner header + keys must fill two cache lines");
+
+typedef struct BTree {
+    BTreeNode *root; // a leaf while the tree is small
+    long size; // number of key/value pairs
+} BTree;
+
+// iterator, points at one key/value pair of a leaf or is past the end when leaf is NULL
+typedef struct BTreeIterator {
+    BTreeLeaf *leaf;
+    int index;
+} BTreeIterator;
+
+static BTreeLeaf *btree_new_leaf(void) {
+    BTreeLeaf *leaf = (BTreeLeaf*)aligned_alloc(CACHE_LINE_SIZE, sizeof(BTreeLeaf));
+    leaf->header.count = 0;
+    leaf->header.is_leaf = true;
+    leaf->next = NULL;
+    return leaf;
+}
+
+static BTreeInner *btree_new_inner(void) {
+    BTreeInner *inner = (BTreeInner*)aligned_alloc(CACHE_LINE_SIZE, sizeof(BTreeInner));
+    inner->header.count = 0;
+    inner->header.is_leaf = false;
+    return inner;
+}
+
+/*
+helpers to search inside a node
+
+Node search:
+    Time Complexity: O(B) for B keys per node, but branch free and vectorized
+    Space Complexity: O(1)
+    lower: index of the first key >= key (position in a leaf)
+    upper: index of the first key > key (child to descend into)
+    (i < count) masks out the unused slots so the trip count stays a constant.
+*/
+static inline int btree_leaf_lower(const BTreeLeaf *leaf, int64_t key) {
+    int pos = 0;
+    for (int i = 0; i < BTREE_LEAF_KEYS; i++) {
+        pos += (i < leaf->header.count) & (leaf->keys[i] < key);
+    }
+    return pos;
+}
+
+static inline int btree_inner_upper(const BTreeInner *inner, int64_t key) {
+    int pos = 0;
+    for (int i = 0; i < BTREE_INNER_KEYS; i++) {
+        pos += (i < inner->header.count) & (inner->keys[i] <= key);
+    }
+    return pos;
+}
+
+// helper to find the leaf that would contain key
+static BTreeLeaf *btree_find_leaf(const BTree *tree, int64_t key) {
+    BTreeNode *node = tree->root;
+    while (!node->is_leaf) {
+        BTreeInner *inner = (BTreeInner*)node;
+        node = inner->children[btree_inner_upper(inner, key)];
+    }
+    return (BTreeLeaf*)node;
+}
+
+// method to initialize empty B+tree
+void init_btree(BTree *tree) {
+    tree->root = &btree_new_leaf()->header;
+    tree->size = 0;
+}
+
+static void btree_free_node(BTreeNode *node) {
+    if (!node->is_leaf) {
+        BTreeInner *inner = (BTreeInner*)node;
+        for (int i = 0; i <= node->count; i++) {
+            btree_free_node(inner->children[i]);
+        }
+    }
+    free(node);
+}
+
+// method to free every node of a B+tree
+void free_btree(BTree *tree) {
+    btree_free_node(tree->root);
+    tree->root = NULL;
+    tree->size = 0;
+}
+
+/*
+method to look up the value of a key
+
+Lookup:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    One node per level, with a fanout of 16 a million keys are only 5 levels deep.
+    Returns false if the key is not in the tree.
+*/
+bool btree_lookup(const BTree *tree, int64_t key, int64_t *value) {
+    BTreeLeaf *leaf = btree_find_leaf(tree, key);
+    int pos = btree_leaf_lower(leaf, key);
+
+    if (pos < leaf->header.count && leaf->keys[pos] == key) {
+        *value = leaf->values[pos];
+        return true;
+    }
+    return false;
+}
+
+/*
+method to find the first key >= key
+
+Lower bound:
+    Time Complexity: O(log n)
+    Space Complexity: O(1)
+    If key is greater than every key of its leaf, the answer is the first key of the
+    next leaf. The iterator is past the end if there is no such key.
+*/
+BTreeIterator btree_lower_bound(const BTree *tree, int64_t key) {
+    BTreeIterator it;
+    it.leaf = btree_find_leaf(tree, key);
+    it.index = btree_leaf_lower(it.leaf, key);
+
+    if (it.index == it.leaf->header.count) {
+        it.leaf = it.leaf->next;
+        it.index = 0;
+    }
+    return it;
+}
+
+// method to check if iterator points at a key/value pair
+bool btree_iter_valid(const BTreeIterator *it) {
+    return it->leaf != NULL;
+}
+
+// method to move iterator to the next larger key, O(1)
+void btree_iter_next(BTreeIterator *it) {
+    if (++it->index == it->leaf->header.count) {
+        it->leaf = it->leaf->next;
+        it->index = 0;
+    }
+}
+
+int64_t btree_iter_key(const BTreeIterator *it) {
+    return it->leaf->keys[it->index];
+}
+
+int64_t btree_iter_value(const BTreeIterator *it) {
+    return it->leaf->values[it->index];
+}
+
+/*
+helper to insert into the subtree of node
+
+If node had to split, the new right sibling is returned through split and the smallest
+key of the right side through split_key, and the caller adds it to its own node.
+Returns true if the key was new, false if only its value was replaced.
+*/
+static bool btree_insert_node(BTreeNode *node, int64_t key, int64_t value, BTreeNode **split, int64_t *split_key) {
+    *split = NULL;
+
+    if (node->is_leaf) {
+        BTreeLeaf *leaf = (BTreeLeaf*)node;
+        int pos = btree_leaf_lower(leaf, key);
+
+        if (pos < node->count && leaf->keys[pos] == key) {
+            leaf->values[pos] = value;
+            return false;
+        }
+
+        if (node->count == BTREE_LEAF_KEYS) {
+            // move the upper half to a new leaf, then insert into the correct half
+            BTreeLeaf *right = btree_new_leaf();
+            int half = BTREE_LEAF_KEYS / 2;
+
+            memcpy(right->keys, leaf->keys + half, (BTREE_LEAF_KEYS - half) * sizeof(int64_t));
+            memcpy(right->values, leaf->values + half, (BTREE_LEAF_KEYS - half) * sizeof(int64_t));
+            right->header.count = BTREE_LEAF_KEYS - half;
+            node->count = half;
+            right->next = leaf->next;
+            leaf->next = right;
+
+            if (pos > half) {
+                leaf = right;
+                pos -= half;
+            }
+            *split = &right->header;
+        }
+
+        memmove(leaf->keys + pos + 1, leaf->keys + pos, (leaf->header.count - pos) * sizeof(int64_t));
+        memmove(leaf->values + pos + 1, leaf->values + pos, (leaf->header.count - pos) * sizeof(int64_t));
+        leaf->keys[pos] = key;
+        leaf->values[pos] = value;
+        leaf->header.count++;
+
+        if (*split != NULL) {
+            *split_key = ((BTreeLeaf*)*split)->keys[0];
+        }
+        return true;
+    }
+
+    BTreeInner *inner = (BTreeInner*)node;
+    int pos = btree_inner_upper(inner, key);
+    BTreeNode *child_split;
+    int64_t child_key;
+    bool inserted = btree_insert_node(inner->children[pos], key, value, &child_split, &child_key);
+
+    if (child_split == NULL) {
+        return inserted;
+    }
+
+    // the child split, child_key and child_split go in at pos / pos + 1
+    if (node->count == BTREE_INNER_KEYS) {
+        /*
+        gather all keys and children in a temporary node that is one key too big, then
+        keep the lower half here, push the middle key up and move the upper half right
+        */
+        int64_t keys[BTREE_INNER_KEYS + 1];
+        BTreeNode *children[BTREE_INNER_KEYS + 2];
+
+        memcpy(keys, inner->keys, pos * sizeof(int64_t));
+        keys[pos] = child_key;
+        memcpy(keys + pos + 1, inner->keys + pos, (BTREE_INNER_KEYS - pos) * sizeof(int64_t));
+        memcpy(children, inner->children, (pos + 1) * sizeof(BTreeNode*));
+        children[pos + 1] = child_split;
+        memcpy(children + pos + 2, inner->children + pos + 1, (BTREE_INNER_KEYS - pos) * sizeof(BTreeNode*));
+
+        int total = BTREE_INNER_KEYS + 1;
+        int half = total / 2;
+        BTreeInner *right = btree_new_inner();
+
+        memcpy(inner->keys, keys, half * sizeof(int64_t));
+        memcpy(inner->children, children, (half + 1) * sizeof(BTreeNode*));
+        node->count = half;
+
+        *split_key = keys[half];
+        memcpy(right->keys, keys + half + 1, (total - half - 1) * sizeof(int64_t));
+        memcpy(right->children, children + half + 1, (total - half) * sizeof(BTreeNode*));
+        right->header.count = total - half - 1;
+
+        *split = &right->header;
+        return inserted;
+    }
+
+    memmove(inner->keys + pos + 1, inner->keys + pos, (node->count - pos) * sizeof(int64_t));
+    memmove(inner->children + pos + 2, inner->children + pos + 1, (node->count - pos) * sizeof(BTreeNode*));
+    inner->keys[pos] = child_key;
+    inner->children[pos + 1] = child_split;
+    node->count++;
+    return inserted;
+}
+
+/*
+method to insert key/value pair into B+tree (replaces the value if key exists)
+
+Insert:
+    Time Complexity: O(log n)
+    Space Complexity: O(log n) for the recursion
+    A full node is split in half on the way back up. If the root splits, a new root
+    with the two halves is added, which is the only way the tree grows taller.
+*/
+bool btree_insert(BTree *tree, int64_t key, int64_t value) {
+    BTreeNode *split;
+    int64_t split_key;
+    bool inserted = btree_insert_node(tree->root, key, value, &split, &split_key);
+
+    if (split != NULL) {
+        BTreeInner *root = btree_new_inner();
+        root->header.count = 1;
+        root->keys[0] = split_key;
+        root->children[0] = tree->root;
+        root->children[1] = split;
+        tree->root = &root->header;
+    }
+
+    if (inserted) {
+        tree->size++;
+    }
+    return inserted;
+}
+
+/*
+helper to fix children[pos] of parent after it fell below the minimum
+
+First try to borrow one key from a sibling that has more than the minimum, otherwise
+merge the child with a sibling, which removes one separator from parent.
+*/
+static void btree_rebalance(BTreeInner *parent, int pos) {
+    BTreeNode *child = parent->children[pos];
+    BTreeNode *left = pos > 0 ? parent->children[pos - 1] : NULL;
+    BTreeNode *right = pos < parent->header.count ? parent->children[pos + 1] : NULL;
+
+    if (child->is_leaf) {
+        BTreeLeaf *leaf = (BTreeLeaf*)child;
+
+        if (left != NULL && left->count > BTREE_LEAF_MIN) {
+            BTreeLeaf *from = (BTreeLeaf*)left;
+            memmove(leaf->keys + 1, leaf->keys, child->count * sizeof(int64_t));
+            memmove(leaf->values + 1, leaf->values, child->count * sizeof(int64_t));
+            leaf->keys[0] = from->keys[left->count - 1];
+            leaf->values[0] = from->values[left->count - 1];
+            left->count--;
+            child->count++;
+            parent->keys[pos - 1] = leaf->keys[0];
+            return;
+        }
+
+        if (right != NULL && right->count > BTREE_LEAF_MIN) {
+            BTreeLeaf *from = (BTreeLeaf*)right;
+            leaf->keys[child->count] = from->keys[0];
+            leaf->values[child->count] = from->values[0];
+            child->count++;
+            right->count--;
+            memmove(from->keys, from->keys + 1, right->count * sizeof(int64_t));
+            memmove(from->values, from->values + 1, right->count * sizeof(int64_t));
+            parent->keys[pos] = from->keys[0];
+            return;
+        }
+    }
+    else {
+        BTreeInner *inner = (BTreeInner*)child;
+
+        if (left != NULL && left->count > BTREE_INNER_MIN) {
+            // rotate right: separator comes down, last key of left goes up
+            BTreeInner *from = (BTreeInner*)left;
+            memmove(inner->keys + 1, inner->keys, child->count * sizeof(int64_t));
+            memmove(inner->children + 1, inner->children, (child->count + 1) * sizeof(BTreeNode*));
+            inner->keys[0] = parent->keys[pos - 1];
+            inner->children[0] = from->children[left->count];
+            parent->keys[pos - 1] = from->keys[left->count - 1];
+            left->count--;
+            child->count++;
+            return;
+        }
+
+        if (right != NULL && right->count > BTREE_INNER_MIN) {
+            // rotate left: separator comes down, first key of right goes up
+            BTreeInner *from = (BTreeInner*)right;
+            inner->keys[child->count] = parent->keys[pos];
+            inner->children[child->count + 1] = from->children[0];
+            parent->keys[pos] = from->keys[0];
+            child->count++;
+            right->count--;
+            memmove(from->keys, from->keys + 1, right->count * sizeof(int64_t));
+            memmove(from->children, from->children + 1, (right->count + 1) * sizeof(BTreeNode*));
+            return;
+        }
+    }
+
+    // no sibling can spare a key: merge children[pos] and children[pos + 1]
+    if (right == NULL) {
+        pos--;
+    }
+    BTreeNode *into = parent->children[pos];
+    BTreeNode *from = parent->children[pos + 1];
+
+    if (into->is_leaf) {
+        BTreeLeaf *a = (BTreeLeaf*)into;
+        BTreeLeaf *b = (BTreeLeaf*)from;
+        memcpy(a->keys + into->count, b->keys, from->count * sizeof(int64_t));
+        memcpy(a->values + into->count, b->values, from->count * sizeof(int64_t));
+        into->count += from->count;
+        a->next = b->next;
+    }
+    else {
+        BTreeInner *a = (BTreeInner*)into;
+        BTreeInner *b = (BTreeInner*)from;
+        a->keys[into->count] = parent->keys[pos]; // separator comes down between the halves
+        memcpy(a->keys + into->count + 1, b->keys, from->count * sizeof(int64_t));
+        memcpy(a->children + into->count + 1, b->children, (from->count + 1) * sizeof(BTreeNode*));
+        into->count += from->count + 1;
+    }
+    free(from);
+
+    memmove(parent->keys + pos, parent->keys + pos + 1, (parent->header.count - pos - 1) * sizeof(int64_t));
+    memmove(parent->children + pos + 1, parent->children + pos + 2, (parent->header.count - pos - 1) * sizeof(BTreeNode*));
+    parent->header.count--;
+}
+
+// helper to delete key from the subtree of node, returns true if the key was found
+static bool btree_delete_node(BTreeNode *node, int64_t key) {
+    if (node->is_leaf) {
+        BTreeLeaf *leaf = (BTreeLeaf*)node;
+        int pos = btree_leaf_lower(leaf, key);
+
+        if (pos == node->count || leaf->keys[pos] != key) {
+            return false;
+        }
+
+        memmove(leaf->keys + pos, leaf->keys + pos + 1, (node->count - pos - 1) * sizeof(int64_t));
+        memmove(leaf->values + pos, leaf->values + pos + 1, (node->count - pos - 1) * sizeof(int64_t));
+        node->count--;
+        return true;
+    }
+
+    BTreeInner *inner = (BTreeInner*)node;
+    int pos = btree_inner_upper(inner, key);
+    BTreeNode *child = inner->children[pos];
+
+    if (!btree_delete_node(child, key)) {
+        return false;
+    }
+
+    int min = child->is_leaf ? BTREE_LEAF_MIN : BTREE_INNER_MIN;
+    if (child->count < min) {
+        btree_rebalance(inner, pos);
+    }
+    return true;
+}
+
+/*
+method to delete key from B+tree
+
+Delete:
+    Time Complexity: O(log n)
+    Space Complexity: O(log n) for the recursion
+    A node that drops below half full borrows from or merges with a sibling, so every
+    node except the root stays at least half full. Separator keys may keep a deleted
+    key, which is fine because they only have to divide the key ranges correctly.
+    If the root ends up with a single child, that child becomes the root.
+*/
+bool btree_delete(BTree *tree, int64_t key) {
+    if (!btree_delete_node(tree->root, key)) {
+        return false;
+    }
+
+    if (!tree->root->is_leaf && tree->root->count == 0) {
+        BTreeNode *old = tree->root;
+        tree->root = ((BTreeInner*)old)->children[0];
+        free(old);
+    }
+
+    tree->size--;
+    return true;
+}
+
+/*
+method to build a B+tree from sorted keys
+
+Bulk load:
+    Time Complexity: O(n)
+    Space Complexity: O(n / B)
+    Inserting sorted keys one by one would split every leaf and leave them half empty.
+    Instead the leaves are filled left to right, then each inner level is built from the
+    level below it until a single root remains. The last two nodes of a level share
+    their entries so that neither is below the minimum.
+    keys must be strictly increasing and the tree empty. Returns false otherwise.
+*/
+bool btree_bulk_load(BTree *tree, const int64_t *keys, const int64_t *values, long n) {
+    if (tree->size != 0) {
+        return false;
+    }
+    for (long i = 1; i < n; i++) {
+        if (keys[i - 1] >= keys[i]) {
+            return false;
+        }
+    }
+    if (n == 0) {
+        return true;
+    }
+
+    long count = (n + BTREE_LEAF_KEYS - 1) / BTREE_LEAF_KEYS;
+    BTreeNode **level = (BTreeNode**)malloc(count * sizeof(BTreeNode*));
+    int64_t *low_keys = (int64_t*)malloc(count * sizeof(int64_t)); // smallest key under each node
+
+    // leaf level
+    BTreeLeaf *previous = NULL;
+    long begin = 0;
+    for (long i = 0; i < count; i++) {
+        long take = n - begin < BTREE_LEAF_KEYS ? n - begin : BTREE_LEAF_KEYS;
+        // split the last two leaves evenly if the last one would be too small
+        if (i == count - 2 && n - begin - BTREE_LEAF_KEYS < BTREE_LEAF_MIN) {
+            take = (n - begin) / 2;
+        }
+
+        BTreeLeaf *leaf = btree_new_leaf();
+        leaf->header.count = (int)take;
+        memcpy(leaf->keys, keys + begin, take * sizeof(int64_t));
+        memcpy(leaf->values, values + begin, take * sizeof(int64_t));
+
+        if (previous != NULL) {
+            previous->next = leaf;
+        }
+        previous = leaf;
+        level[i] = &leaf->header;
+        low_keys[i] = keys[begin];
+        begin += take;
+    }
+
+    // inner levels, each node takes up to BTREE_INNER_KEYS + 1 children
+    const int fanout = BTREE_INNER_KEYS + 1;
+    const int min_children = BTREE_INNER_MIN + 1;
+    while (count > 1) {
+        long parents = (count + fanout - 1) / fanout;
+        long child = 0;
+
+        for (long i = 0; i < parents; i++) {
+            long take = count - child < fanout ? count - child : fanout;
+            // split the last two parents evenly if the last one would be too small
+            if (i == parents - 2 && count - child - fanout < min_children) {
+                take = (count - child) / 2;
+            }
+
+            BTreeInner *inner = btree_new_inner();
+            for (long c = 0; c < take; c++) {
+                inner->children[c] = level[child + c];
+                if (c > 0) {
+                    inner->keys[c - 1] = low_keys[child + c];
+                }
+            }
+            inner->header.count = (int)take - 1;
+
+            low_keys[i] = low_keys[child];
+            level[i] = &inner->header;
+            child += take;
+        }
+        count = parents;
+    }
+
+    free(tree->root);
+    tree->root = level[0];
+    tree->size = n;
+
+    free(level);
+    free(low_keys);
+    return true;
+}
+
+// method to display B+tree keys in order
+void display_btree(const BTree *tree) {
+    bool first = true;
+
+    printf("\nB+tree (%ld): [", tree->size);
+    for (BTreeIterator it = btree_lower_bound(tree, INT64_MIN); btree_iter_valid(&it); btree_iter_next(&it)) {
+        printf("%s%lld", first ? "" : ", ", (long long)btree_iter_key(&it));
+        first = false;
+    }
+    printf("]\n");
+}
+
+/*
+adaptive radix tree class (string keys)
+
+A radix tree indexes keys byte by byte: the child of a node for byte c holds the keys
+that continue with c. That answers prefix queries and gives ordered iteration for free,
+which a hash map can't. The adaptive part keeps it small: a node comes in four sizes
+(4, 16, 48 or 256 children) and grows or shrinks as children are added or removed.
+    Node4     keys and children in two small sorted arrays
+    Node16    same with 16, searched with one SSE compare of all 16 key bytes
+    Node48    a 256 byte index into 48 children
+    Node256   a plain array of 256 children
+Two more tricks (Leis et al., "The Adaptive Radix Tree", ICDE 2013):
+    path compression   a chain of nodes with a single child is stored as a prefix in
+                       the node below it, up to ART_MAX_PREFIX bytes, the rest is
+                       compared against a leaf when needed
+    lazy expansion     a subtree with only one key is just that key's leaf, so there
+                       are never more inner nodes than keys
+Leaves store the key with its terminating '\0' as the last byte, so no key is a prefix
+of another and every key ends in its own leaf. A child pointer with the lowest bit set
+points to a leaf instead of a node.
+*/
+enum { ART_NODE4 = 1, ART_NODE16, ART_NODE48, ART_NODE256 };
+
+typedef struct ArtNode {
+    uint8_t type; // ART_NODE4 ... ART_NODE256
+    uint16_t num_children;
+    uint32_t prefix_len; // length of the compressed path, may exceed ART_MAX_PREFIX
+    unsigned char prefix[ART_MAX_PREFIX]; // first bytes of the compressed path
+} ArtNode;
+
+typedef struct ArtNode4 {
+    ArtNode n;
+    unsigned char keys[4];
+    ArtNode *children[4];
+} ArtNode4;
+
+typedef struct ArtNode16 {
+    ArtNode n;
+    unsigned char keys[16];
+    ArtNode *children[16];
+} ArtNode16;
+
+typedef struct ArtNode48 {
+    ArtNode n;
+    unsigned char child_index[256]; // 0 if no child for the byte, else index + 1
+    ArtNode *children[48];
+} ArtNode48;
+
+typedef struct ArtNode256 {
+    ArtNode n;
+    ArtNode *children[256];
+} ArtNode256;
+
+typedef struct ArtLeaf {
+    char *data; // value associated with the key
+    uint32_t key_len; // including the terminating '\0'
+    unsigned char key[]; // the full key
+} ArtLeaf;
+
+typedef struct ArtTree {
+    ArtNode *root;
+    long size; // number of keys
+} ArtTree;
+
+// callback for iteration, return non-zero to stop
+typedef int (*ArtCallback)(void *context, const char *key, char *data);
+
+#define ART_IS_LEAF(x) (((uintptr_t)(x)) & 1)
+#define ART_SET_LEAF(x) ((ArtNode*)((uintptr_t)(x) | 1))
+#define ART_LEAF_RAW(x) ((ArtLeaf*)((uintptr_t)(x) & ~(uintptr_t)1))
+
+static inline uint32_t art_min(uint32_t a, uint32_t b) {
+    return a < b ? a : b;
+}
+
+// method to initialize empty adaptive radix tree
+void init_art(ArtTree *tree) {
+    tree->root = NULL;
+    tree->size = 0;
+}
+
+static ArtNode *art_alloc_node(uint8_t type) {
+    size_t size = type == ART_NODE4 ? sizeof(ArtNode4)
+        : type == ART_NODE16 ? sizeof(ArtNode16)
+        : type == ART_NODE48 ? sizeof(ArtNode48)
+        : sizeof(ArtNode256);
+    ArtNode *node = (ArtNode*)calloc(1, size);
+    node->type = type;
+    return node;
+}
+
+static void art_free_node(ArtNode *node) {
+    if (node == NULL) {
+        return;
+    }
+    if (ART_IS_LEAF(node)) {
+        free(ART_LEAF_RAW(node));
+        return;
+    }
+
+    switch (node->type) {
+        case ART_NODE4:
+            for (int i = 0; i < node->num_children; i++) {
+                art_free_node(((ArtNode4*)node)->children[i]);
+            }
+            break;
+        case ART_NODE16:
+            for (int i = 0; i < node->num_children; i++) {
+                art_free_node(((ArtNode16*)node)->children[i]);
+            }
+            break;
+        case ART_NODE48:
+            for (int i = 0; i < 48; i++) {
+                art_free_node(((ArtNode48*)node)->children[i]);
+            }
+            break;
+        case ART_NODE256:
+            for (int i = 0; i < 256; i++) {
+                art_free_node(((ArtNode256*)node)->children[i]);
+            }
+            break;
+    }
+    free(node);
+}
+
+// method to free every node and leaf of an adaptive radix tree (the data strings are not freed)
+void free_art(ArtTree *tree) {
+    art_free_node(tree->root);
+    init_art(tree);
+}
+
+/*
+helper to find the child slot for byte c, NULL if there is none
+
+Find child:
+    Time Complexity: O(1)
+    Space Complexity: O(1)
+    Node4 is a tiny loop, Node16 compares all 16 keys at once with SSE and turns the
+    result into a bitmask, Node48 and Node256 are a direct index.
+*/
+static ArtNode **art_find_child(ArtNode *node, unsigned char c) {
+    switch (node->type) {
+        case ART_NODE4: {
+            ArtNode4 *n = (ArtNode4*)node;
+            for (int i = 0; i < node->num_children; i++) {
+                if (n->keys[i] == c) {
+                    return &n->children[i];
+                }
+            }
+            return NULL;
+        }
+        case ART_NODE16: {
+            ArtNode16 *n = (ArtNode16*)node;
+#ifdef __SSE2__
+            __m128i equal = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i*)n->keys));
+            int bits = _mm_movemask_epi8(equal) & ((1 << node->num_children) - 1);
+            return bits ? &n->children[__builtin_ctz(bits)] : NULL;
+#else
+            for (int i = 0; i < node->num_children; i++) {
+                if (n->keys[i] == c) {
+                    return &n->children[i];
+                }
+            }
+            return NULL;
+#endif
+        }
+        case ART_NODE48: {
+            ArtNode48 *n = (ArtNode48*)node;
+            return n->child_index[c] ? &n->children[n->child_index[c] - 1] : NULL;
+        }
+        default: {
+            ArtNode256 *n = (ArtNode256*)node;
+            return n->children[c] ? &n->children[c] : NULL;
+        }
+    }
+}
+
+// helper to find the leaf with the smallest key below node
+static ArtLeaf *art_minimum(ArtNode *node) {
+    while (node != NULL && !ART_IS_LEAF(node)) {
+        switch (node->type) {
+            case ART_NODE4:
+                node = ((ArtNode4*)node)->children[0];
+                break;
+            case ART_NODE16:
+                node = ((ArtNode16*)node)->children[0];
+                break;
+            case ART_NODE48: {
+                ArtNode48 *n = (ArtNode48*)node;
+                int c = 0;
+                while (!n->child_index[c]) {
+                    c++;
+                }
+                node = n->children[n->child_index[c] - 1];
+                break;
+            }
+            default: {
+                ArtNode256 *n = (ArtNode256*)node;
+                int c = 0;
+                while (!n->children[c]) {
+                    c++;
+                }
+                node = n->children[c];
+                break;
+            }
+        }
+    }
+    return node != NULL ? ART_LEAF_RAW(node) : NULL;
+}
+
+static bool art_leaf_matches(const ArtLeaf *leaf, const unsigned char *key, uint32_t key_len) {
+    return leaf->key_len == key_len && memcmp(leaf->key, key, key_len) == 0;
+}
+
+/*
+helper to count how many bytes of the compressed path of node match key at depth
+
+Only the stored ART_MAX_PREFIX bytes are compared directly. If the path is longer, the
+remaining bytes are read from any leaf below the node, since all of them share the path.
+*/
+static uint32_t art_prefix_mismatch(ArtNode *node, const unsigned char *key, uint32_t key_len, uint32_t depth) {
+    uint32_t limit = art_min(art_min(ART_MAX_PREFIX, node->prefix_len), key_len - depth);
+    uint32_t i;
+
+    for (i = 0; i < limit; i++) {
+        if (node->prefix[i] != key[depth + i]) {
+            return i;
+        }
+    }
+
+    if (node->prefix_len > ART_MAX_PREFIX) {
+        ArtLeaf *leaf = art_minimum(node);
+        limit = art_min(art_min(leaf->key_len, key_len) - depth, node->prefix_len);
+        for (; i < limit; i++) {
+            if (leaf->key[depth + i] != key[depth + i]) {
+                return i;
+            }
+        }
+    }
+    return i;
+}
+
+/*
+method to look up the data of a key
+
+ART lookup:
+    Time Complexity: O(k) for a key of k bytes, independent of the number of keys
+    Space Complexity: O(1)
+    Compressed paths are only checked on their stored bytes on the way down (optimistic),
+    the final comparison with the leaf catches any mismatch in the rest.
+    Returns NULL if the key is not in the tree.
+*/
+char *art_lookup(const ArtTree *tree, const char *string) {
+    const unsigned char *key = (const unsigned char*)string;
+    uint32_t key_len = (uint32_t)strlen(string) + 1;
+    ArtNode *node = tree->root;
+    uint32_t depth = 0;
+
+    while (node != NULL) {
+        if (ART_IS_LEAF(node)) {
+            ArtLeaf *leaf = ART_LEAF_RAW(node);
+            return art_leaf_matches(leaf, key, key_len) ? leaf->data : NULL;
+        }
+
+        if (node->prefix_len > 0) {
+            uint32_t stored = art_min(ART_MAX_PREFIX, node->prefix_len);
+            if (depth + node->prefix_len >= key_len || memcmp(node->prefix, key + depth, stored) != 0) {
+                return NULL;
+            }
+            depth += node->prefix_len;
+        }
+
+        ArtNode **child = art_find_child(node, key[depth]);
+        node = child != NULL ? *child : NULL;
+        depth++;
+    }
+    return NULL;
+}
+
+static ArtLeaf *art_make_leaf(const unsigned char *key, uint32_t key_len, char *data) {
+    ArtLeaf *leaf = (ArtLeaf*)malloc(sizeof(ArtLeaf) + key_len);
+    leaf->data = data;
+    leaf->key_len = key_len;
+    memcpy(leaf->key, key, key_len);
+    return leaf;
+}
+
+static void art_copy_header(ArtNode *to, const ArtNode *from) {
+    to->num_children = from->num_children;
+    to->prefix_len = from->prefix_len;
+    memcpy(to->prefix, from->prefix, art_min(ART_MAX_PREFIX, from->prefix_len));
+}
+
+static void art_add_child(ArtNode *node, ArtNode **ref, unsigned char c, ArtNode *child);
+
+static void art_add_child256(ArtNode256 *node, unsigned char c, ArtNode *child) {
+    node->n.num_children++;
+    node->children[c] = child;
+}
+
+static void art_add_child48(ArtNode48 *node, ArtNode **ref, unsigned char c, ArtNode *child) {
+    if (node->n.num_children < 48) {
+        int pos = 0;
+        while (node->children[pos] != NULL) {
+            pos++;
+        }
+        node->children[pos] = child;
+        node->child_index[c] = (unsigned char)(pos + 1);
+        node->n.num_children++;
+        return;
+    }
+
+    // full, grow to Node256
+    ArtNode256 *bigger = (ArtNode256*)art_alloc_node(ART_NODE256);
+    for (int i = 0; i < 256; i++) {
+        if (node->child_index[i]) {
+            bigger->children[i] = node->children[node->child_index[i] - 1];
+        }
+    }
+    art_copy_header(&bigger->n, &node->n);
+    *ref = &bigger->n;
+    free(node);
+    art_add_child256(bigger, c, child);
+}
+
+static void art_add_child16(ArtNode16 *node, ArtNode **ref, unsigned char c, ArtNode *child) {
+    if (node->n.num_children < 16) {
+        int pos = 0;
+        while (pos < node->n.num_children && node->keys[pos] < c) {
+            pos++;
+        }
+        memmove(node->keys + pos + 1, node->keys + pos, node->n.num_children - pos);
+        memmove(node->children + pos + 1, node->children + pos, (node->n.num_children - pos) * sizeof(ArtNode*));
+        node->keys[pos] = c;
+        node->children[pos] = child;
+        node->n.num_children++;
+        return;
+    }
+
+    // full, grow to Node48
+    ArtNode48 *bigger = (ArtNode48*)art_alloc_node(ART_NODE48);
+    memcpy(bigger->children, node->children, 16 * sizeof(ArtNode*));
+    for (int i = 0; i < 16; i++) {
+        bigger->child_index[node->keys[i]] = (unsigned char)(i + 1);
+    }
+    art_copy_header(&bigger->n, &node->n);
+    *ref = &bigger->n;
+    free(node);
+    art_add_child48(bigger, ref, c, child);
+}
+
+static void art_add_child4(ArtNode4 *node, ArtNode **ref, unsigned char c, ArtNode *child) {
+    if (node->n.num_children < 4) {
+        int pos = 0;
+        while (pos < node->n.num_children && node->keys[pos] < c) {
+            pos++;
+        }
+        memmove(node->keys + pos + 1, node->keys + pos, node->n.num_children - pos);
+        memmove(node->children + pos + 1, node->children + pos, (node->n.num_children - pos) * sizeof(ArtNode*));
+        node->keys[pos] = c;
+        node->children[pos] = child;
+        node->n.num_children++;
+        return;
+    }
+
+    // full, grow to Node16
+    ArtNode16 *bigger = (ArtNode16*)art_alloc_node(ART_NODE16);
+    memcpy(bigger->keys, node->keys, 4);
+    memcpy(bigger->children, node->children, 4 * sizeof(ArtNode*));
+    art_copy_header(&bigger->n, &node->n);
+    *ref = &bigger->n;
+    free(node);
+    art_add_child16(bigger, ref, c, child);
+}
+
+// helper to add child for byte c, node may be replaced by a bigger node through ref
+static void art_add_child(ArtNode *node, ArtNode **ref, unsigned char c, ArtNode *child) {
+    switch (node->type) {
+        case ART_NODE4:
+            art_add_child4((ArtNode4*)node, ref, c, child);
+            break;
+        case ART_NODE16:
+            art_add_child16((ArtNode16*)node, ref, c, child);
+            break;
+        case ART_NODE48:
+            art_add_child48((ArtNode48*)node, ref, c, child);
+            break;
+        default:
+            art_add_child256((ArtNode256*)node, c, child);
+            break;
+    }
+}
+
+// helper to insert below node (stored in *ref), returns the old data if the key existed
+static char *art_insert_node(ArtNode *node, ArtNode **ref, const unsigned char *key, uint32_t key_len,
+        char *data, uint32_t depth, bool *replaced) {
+    if (node == NULL) {
+        *ref = ART_SET_LEAF(art_make_leaf(key, key_len, data));
+        return NULL;
+    }
+
+    if (ART_IS_LEAF(node)) {
+        ArtLeaf *leaf = ART_LEAF_RAW(node);
+        if (art_leaf_matches(leaf, key, key_len)) {
+            char *old = leaf->data;
+            leaf->data = data;
+            *replaced = true;
+            return old;
+        }
+
+        // lazy expansion ends here: two keys now share this spot, split on their first difference
+        ArtNode4 *split = (ArtNode4*)art_alloc_node(ART_NODE4);
+        uint32_t limit = art_min(leaf->key_len, key_len) - depth;
+        uint32_t common = 0;
+        while (common < limit && leaf->key[depth + common] == key[depth + common]) {
+            common++;
+        }
+
+        split->n.prefix_len = common;
+        memcpy(split->n.prefix, key + depth, art_min(ART_MAX_PREFIX, common));
+        *ref = &split->n;
+        art_add_child4(split, ref, leaf->key[depth + common], node);
+        art_add_child4(split, ref, key[depth + common], ART_SET_LEAF(art_make_leaf(key, key_len, data)));
+        return NULL;
+    }
+
+    if (node->prefix_len > 0) {
+        uint32_t match = art_prefix_mismatch(node, key, key_len, depth);
+
+        if (match < node->prefix_len) {
+            // key leaves the compressed path: put a new node above at the point of difference
+            ArtNode4 *split = (ArtNode4*)art_alloc_node(ART_NODE4);
+            split->n.prefix_len = match;
+            memcpy(split->n.prefix, node->prefix, art_min(ART_MAX_PREFIX, match));
+            *ref = &split->n;
+
+            if (node->prefix_len <= ART_MAX_PREFIX) {
+                art_add_child4(split, ref, node->prefix[match], node);
+                node->prefix_len -= match + 1;
+                memmove(node->prefix, node->prefix + match + 1, art_min(ART_MAX_PREFIX, node->prefix_len));
+            }
+            else {
+                // the bytes after the stored prefix have to come from a leaf
+                ArtLeaf *leaf = art_minimum(node);
+                node->prefix_len -= match + 1;
+                art_add_child4(split, ref, leaf->key[depth + match], node);
+                memcpy(node->prefix, leaf->key + depth + match + 1, art_min(ART_MAX_PREFIX, node->prefix_len));
+            }
+
+            art_add_child4(split, ref, key[depth + match], ART_SET_LEAF(art_make_leaf(key, key_len, data)));
+            return NULL;
+        }
+        depth += node->prefix_len;
+    }
+
+    ArtNode **child = art_find_child(node, key[depth]);
+    if (child != NULL) {
+        return art_insert_node(*child, child, key, key_len, data, depth + 1, replaced);
+    }
+
+    art_add_child(node, ref, key[depth], ART_SET_LEAF(art_make_leaf(key, key_len, data)));
+    return NULL;
+}
+
+/*
+method to insert key with data into adaptive radix tree (replaces the data if key exists)
+
+ART insert:
+    Time Complexity: O(k) for a key of k bytes
+    Space Complexity: O(k) for the new leaf
+    At most one new inner node is created per insert: when the key splits a leaf or a
+    compressed path. A full node is replaced by the next bigger node type.
+    Returns the old data if the key existed, NULL otherwise.
+*/
+char *art_insert(ArtTree *tree, const char *string, char *data) {
+    bool replaced = false;
+    char *old = art_insert_node(tree->root, &tree->root, (const unsigned char*)string,
+        (uint32_t)strlen(string) + 1, data, 0, &replaced);
+
+    if (!replaced) {
+        tree->size++;
+    }
+    return old;
+}
+
+// helpers to remove the child for byte c from a node, shrinking the node type when it gets sparse
+static void art_remove_child256(ArtNode256 *node, ArtNode **ref, unsigned char c) {
+    node->children[c] = NULL;
+    node->n.num_children--;
+
+    // shrink a bit below the Node48 capacity so add/remove at the boundary doesn't flip back and forth
+    if (node->n.num_children == 37) {
+        ArtNode48 *smaller = (ArtNode48*)art_alloc_node(ART_NODE48);
+        art_copy_header(&smaller->n, &node->n);
+        int pos = 0;
+        for (int i = 0; i < 256; i++) {
+            if (node->children[i]) {
+                smaller->children[pos] = node->children[i];
+                smaller->child_index[i] = (unsigned char)(pos + 1);
+                pos++;
+            }
+        }
+        *ref = &smaller->n;
+        free(node);
+    }
+}
+
+static void art_remove_child48(ArtNode48 *node, ArtNode **ref, unsigned char c) {
+    int pos = node->child_index[c] - 1;
+    node->children[pos] = NULL;
+    node->child_index[c] = 0;
+    node->n.num_children--;
+
+    if (node->n.num_children == 12) {
+        ArtNode16 *smaller = (ArtNode16*)art_alloc_node(ART_NODE16);
+        art_copy_header(&smaller->n, &node->n);
+        int count = 0;
+        for (int i = 0; i < 256; i++) {
+            if (node->child_index[i]) {
+                smaller->keys[count] = (unsigned char)i;
+                smaller->children[count] = node->children[node->child_index[i] - 1];
+                count++;
+            }
+        }
+        *ref = &smaller->n;
+        free(node);
+    }
+}
+
+static void art_remove_child16(ArtNode16 *node, ArtNode **ref, ArtNode **slot) {
+    int pos = (int)(slot - node->children);
+    memmove(node->keys + pos, node->keys + pos + 1, node->n.num_children - 1 - pos);
+    memmove(node->children + pos, node->children + pos + 1, (node->n.num_children - 1 - pos) * sizeof(ArtNode*));
+    node->n.num_children--;
+
+    if (node->n.num_children == 3) {
+        ArtNode4 *smaller = (ArtNode4*)art_alloc_node(ART_NODE4);
+        art_copy_header(&smaller->n, &node->n);
+        memcpy(smaller->keys, node->keys, 3);
+        memcpy(smaller->children, node->children, 3 * sizeof(ArtNode*));
+        *ref = &smaller->n;
+        free(node);
+    }
+}
+
+static void art_remove_child4(ArtNode4 *node, ArtNode **ref, ArtNode **slot) {
+    int pos = (int)(slot - node->children);
+    memmove(node->keys + pos, node->keys + pos + 1, node->n.num_children - 1 - pos);
+    memmove(node->children + pos, node->children + pos + 1, (node->n.num_children - 1 - pos) * sizeof(ArtNode*));
+    node->n.num_children--;
+
+    if (node->n.num_children > 1) {
+        return;
+    }
+
+    /*
+    only one child left: the node is no longer needed. If the child is an inner node,
+    this node's path, the byte of the child and the child's path are joined into the
+    child's compressed path. A leaf keeps its full key and needs nothing.
+    */
+    ArtNode *child = node->children[0];
+    if (!ART_IS_LEAF(child)) {
+        uint32_t prefix = node->n.prefix_len;
+        if (prefix < ART_MAX_PREFIX) {
+            node->n.prefix[prefix] = node->keys[0];
+            prefix++;
+        }
+        if (prefix < ART_MAX_PREFIX) {
+            uint32_t sub = art_min(child->prefix_len, ART_MAX_PREFIX - prefix);
+            memcpy(node->n.prefix + prefix, child->prefix, sub);
+            prefix += sub;
+        }
+
+        memcpy(child->prefix, node->n.prefix, art_min(prefix, ART_MAX_PREFIX));
+        child->prefix_len += node->n.prefix_len + 1;
+    }
+    *ref = child;
+    free(node);
+}
+
+static void art_remove_child(ArtNode *node, ArtNode **ref, unsigned char c, ArtNode **slot) {
+    switch (node->type) {
+        case ART_NODE4:
+            art_remove_child4((ArtNode4*)node, ref, slot);
+            break;
+        case ART_NODE16:
+            art_remove_child16((ArtNode16*)node, ref, slot);
+            break;
+        case ART_NODE48:
+            art_remove_child48((ArtNode48*)node, ref, c);
+            break;
+        default:
+            art_remove_child256((ArtNode256*)node, ref, c);
+            break;
+    }
+}
+
+// helper to delete key below node (stored in *ref), returns the removed leaf or NULL
+static ArtLeaf *art_delete_node(ArtNode *node, ArtNode **ref, const unsigned char *key, uint32_t key_len, uint32_t depth) {
+    if (node == NULL) {
+        return NULL;
+    }
+
+    if (ART_IS_LEAF(node)) {
+        ArtLeaf *leaf = ART_LEAF_RAW(node);
+        if (art_leaf_matches(leaf, key, key_len)) {
+            *ref = NULL;
+            return leaf;
+        }
+        return NULL;
+    }
+
+    if (node->prefix_len > 0) {
+        if (art_prefix_mismatch(node, key, key_len, depth) < node->prefix_len) {
+            return NULL;
+        }
+        depth += node->prefix_len;
+    }
+    if (depth >= key_len) {
+        return NULL;
+    }
+
+    ArtNode **child = art_find_child(node, key[depth]);
+    if (child == NULL) {
+        return NULL;
+    }
+
+    if (ART_IS_LEAF(*child)) {
+        ArtLeaf *leaf = ART_LEAF_RAW(*child);
+        if (!art_leaf_matches(leaf, key, key_len)) {
+            return NULL;
+        }
+        art_remove_child(node, ref, key[depth], child);
+        return leaf;
+    }
+    return art_delete_node(*child, child, key, key_len, depth + 1);
+}
+
+/*
+method to delete key from adaptive radix tree
+
+ART delete:
+    Time Complexity: O(k) for a key of k bytes
+    Space Complexity: O(1)
+    The leaf is removed from its parent, which may shrink to a smaller node type or,
+    if only one child is left, be merged into that child's compressed path.
+    Returns the data of the deleted key, or NULL if it was not in the tree.
+*/
+char *art_delete(ArtTree *tree, const char *string) {
+    ArtLeaf *leaf = art_delete_node(tree->root, &tree->root, (const unsigned char*)string,
+        (uint32_t)strlen(string) + 1, 0);
+
+    if (leaf == NULL) {
+        return NULL;
+    }
+
+    char *data = leaf->data;
+    free(leaf);
+    tree->size--;
+    return data;
+}
+
+// helper to call callback on every leaf below node in key order
+static int art_iterate_node(ArtNode *node, ArtCallback callback, void *context) {
+    if (node == NULL) {
+        return 0;
+    }
+    if (ART_IS_LEAF(node)) {
+        ArtLeaf *leaf = ART_LEAF_RAW(node);
+        return callback(context, (const char*)leaf->key, leaf->data);
+    }
+
+    int stop = 0;
+    switch (node->type) {
+        case ART_NODE4:
+            for (int i = 0; i < node->num_children && !stop; i++) {
+                stop = art_iterate_node(((ArtNode4*)node)->children[i], callback, context);
+            }
+            break;
+        case ART_NODE16:
+            for (int i = 0; i < node->num_children && !stop; i++) {
+                stop = art_iterate_node(((ArtNode16*)node)->children[i], callback, context);
+            }
+            break;
+        case ART_NODE48: {
+            ArtNode48 *n = (ArtNode48*)node;
+            for (int i = 0; i < 256 && !stop; i++) {
+                if (n->child_index[i]) {
+                    stop = art_iterate_node(n->children[n->child_index[i] - 1], callback, context);
+                }
+            }
+            break;
+        }
+        default:
+            for (int i = 0; i < 256 && !stop; i++) {
+                stop = art_iterate_node(((ArtNode256*)node)->children[i], callback, context);
+            }
+            break;
+    }
+    return stop;
+}
+
+/*
+method to call callback on every key in ascending (byte-wise) order
+
+ART iterate:
+    Time Complexity: O(n)
+    Space Complexity: O(k) recursion for the longest key
+    Children are visited in byte order and '\0' ends every key, so shorter keys come
+    before the keys they are a prefix of. Stops early if callback returns non-zero.
+*/
+int art_iterate(const ArtTree *tree, ArtCallback callback, void *context) {
+    return art_iterate_node(tree->root, callback, context);
+}
+
+/*
+method to call callback on every key that starts with prefix, in ascending order
+
+ART prefix iterate:
+    Time Complexity: O(p + m) for a prefix of p bytes and m matching keys
+    Space Complexity: O(k)
+    Walks down as in a lookup until the prefix is used up, then every key below that
+    node matches and the whole subtree is iterated.
+*/
+int art_iterate_prefix(const ArtTree *tree, const char *string, ArtCallback callback, void *context) {
+    const unsigned char *prefix = (const unsigned char*)string;
+    uint32_t prefix_len = (uint32_t)strlen(string); // without '\0', keys may continue
+    ArtNode *node = tree->root;
+    uint32_t depth = 0;
+
+    while (node != NULL) {
+        if (ART_IS_LEAF(node)) {
+            ArtLeaf *leaf = ART_LEAF_RAW(node);
+            if (leaf->key_len > prefix_len && memcmp(leaf->key, prefix, prefix_len) == 0) {
+                return callback(context, (const char*)leaf->key, leaf->data);
+            }
+            return 0;
+        }
+
+        if (depth == prefix_len) {
+            return art_iterate_node(node, callback, context);
+        }
+
+        if (node->prefix_len > 0) {
+            uint32_t match = art_prefix_mismatch(node, prefix, prefix_len, depth);
+            if (depth + match == prefix_len) {
+                return art_iterate_node(node, callback, context); // prefix ends inside the path
+            }
+            if (match < node->prefix_len) {
+                return 0;
+            }
+            depth += node->prefix_len;
+        }
+
+        ArtNode **child = art_find_child(node, prefix[depth]);
+        node = child != NULL ? *child : NULL;
+        depth++;
+    }
+    return 0;
+}
+
+static int art_print_key(void *context, const char *key, char *data) {
+    (void)context;
+    printf("\t%s -> %s\n", key, data);
+    return 0;
+}
+
+/*
+B+tree benchmark
+
+point lookups: against a separate chaining hash map built like HashMap in hash.c, but
+with int64 keys and one bucket per key (hash.c's map is fixed at 100 buckets and
+compares string pointers, so it cannot hold a million keys)
+range scans: against binary search + sequential walk over a sorted array
+*/
+#define BTREE_BENCH_COUNT (1 << 20)
+#define BTREE_BENCH_LOOKUPS (1 << 20)
+#define BTREE_BENCH_SCANS 10000
+#define BTREE_BENCH_SCAN_LENGTH 1000
+
+typedef struct BenchHashNode {
+    int64_t key;
+    int64_t data;
+    struct BenchHashNode *next;
+} BenchHashNode;
+
+static inline uint64_t bench_hash(int64_t key) {
+    uint64_t x = (uint64_t)key * 0x9E3779B97F4A7C15ULL;
+    return x ^ (x >> 29);
+}
+
+static int compare_int64(const void *a, const void *b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t bench_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+void btree_benchmark(void) {
+    int64_t *keys = (int64_t*)malloc(BTREE_BENCH_COUNT * sizeof(int64_t));
+    int64_t *probes = (int64_t*)malloc(BTREE_BENCH_LOOKUPS * sizeof(int64_t));
+    uint64_t state = 88172645463325252ULL;
+
+    // distinct sorted keys, spaced out so range scans start between keys
+    for (long i = 0; i < BTREE_BENCH_COUNT; i++) {
+        keys[i] = (int64_t)(bench_random(&state) >> 24);
+    }
+    qsort(keys, BTREE_BENCH_COUNT, sizeof(int64_t), compare_int64);
+    long n = 0;
+    for (long i = 0; i < BTREE_BENCH_COUNT; i++) {
+        if (n == 0 || keys[i] != keys[n - 1]) {
+            keys[n++] = keys[i];
+        }
+    }
+    for (long i = 0; i < BTREE_BENCH_LOOKUPS; i++) {
+        probes[i] = keys[bench_random(&state) % n];
+    }
+
+    BTree tree;
+    init_btree(&tree);
+    long long start = now_ns();
+    btree_bulk_load(&tree, keys, keys, n);
+    long long load_time = now_ns() - start;
+
+    long buckets = 1;
+    while (buckets < n) {
+        buckets <<= 1;
+    }
+    BenchHashNode **table = (BenchHashNode**)calloc(buckets, sizeof(BenchHashNode*));
+    BenchHashNode *nodes = (BenchHashNode*)malloc(n * sizeof(BenchHashNode));
+    for (long i = 0; i < n; i++) {
+        long bucket = (long)(bench_hash(keys[i]) & (buckets - 1));
+        nodes[i].key = keys[i];
+        nodes[i].data = keys[i];
+        nodes[i].next = table[bucket];
+        table[bucket] = &nodes[i];
+    }
+
+    printf("\nB+tree benchmark (%ld keys, bulk load %.2f ms):\n", n, load_time / 1e6);
+
+    int64_t sum_tree = 0;
+    int64_t sum_hash = 0;
+    start = now_ns();
+    for (long i = 0; i < BTREE_BENCH_LOOKUPS; i++) {
+        int64_t value;
+        if (btree_lookup(&tree, probes[i], &value)) {
+            sum_tree += value;
+        }
+    }
+    long long tree_time = now_ns() - start;
+
+    start = now_ns();
+    for (long i = 0; i < BTREE_BENCH_LOOKUPS; i++) {
+        BenchHashNode *node = table[bench_hash(probes[i]) & (buckets - 1)];
+        while (node != NULL && node->key != probes[i]) {
+            node = node->next;
+        }
+        if (node != NULL) {
+            sum_hash += node->data;
+        }
+    }
+    long long hash_time = now_ns() - start;
+
+    printf("point lookups: B+tree %6.1f ns, chained hash map %6.1f ns %s\n", (double)tree_time / BTREE_BENCH_LOOKUPS,
+        (double)hash_time / BTREE_BENCH_LOOKUPS, sum_tree == sum_hash ? "" : "(mismatch)");
+
+    sum_tree = 0;
+    int64_t sum_array = 0;
+    start = now_ns();
+    for (long i = 0; i < BTREE_BENCH_SCANS; i++) {
+        int count = 0;
+        for (BTreeIterator it = btree_lower_bound(&tree, probes[i] - 1);
+                btree_iter_valid(&it) && count < BTREE_BENCH_SCAN_LENGTH; btree_iter_next(&it), count++) {
+            sum_tree += btree_iter_value(&it);
+        }
+    }
+    tree_time = now_ns() - start;
+
+    start = now_ns();
+    for (long i = 0; i < BTREE_BENCH_SCANS; i++) {
+        long low = 0;
+        long high = n;
+        while (low < high) {
+            long middle = low + (high - low) / 2;
+            if (keys[middle] < probes[i] - 1) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        for (long j = low; j < n && j < low + BTREE_BENCH_SCAN_LENGTH; j++) {
+            sum_array += keys[j];
+        }
+    }
+    long long array_time = now_ns() - start;
+
+    printf("range scans of %d keys: B+tree %6.2f us, sorted array %6.2f us %s\n", BTREE_BENCH_SCAN_LENGTH,
+        tree_time / 1e3 / BTREE_BENCH_SCANS, array_time / 1e3 / BTREE_BENCH_SCANS, sum_tree == sum_array ? "" : "(mismatch)");
+
+    free_btree(&tree);
+    free(table);
+    free(nodes);
+    free(keys);
+    free(probes);
+}
+
+/*
+adaptive radix tree benchmark
+
+point lookups of route-like string keys against a separate chaining hash map like
+HashMap in hash.c, but with one bucket per key and strcmp instead of pointer comparison
+(hash.c's map has a fixed 100 buckets and only finds the exact pointer it was given)
+*/
+#define ART_BENCH_COUNT (1 << 19)
+#define ART_BENCH_LOOKUPS (1 << 20)
+
+typedef struct BenchStringNode {
+    char *key;
+    char *data;
+    struct BenchStringNode *next;
+} BenchStringNode;
+
+// FNV-1a hash of a string
+static uint64_t bench_string_hash(const char *key) {
+    uint64_t hash = 14695981039346656037ULL;
+    while (*key) {
+        hash = (hash ^ (unsigned char)*key++) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+void art_benchmark(void) {
+    char **keys = (char**)malloc(ART_BENCH_COUNT * sizeof(char*));
+    char **probes = (char**)malloc(ART_BENCH_LOOKUPS * sizeof(char*));
+    uint64_t state = 88172645463325252ULL;
+    size_t key_bytes = 0;
+
+    for (long i = 0; i < ART_BENCH_COUNT; i++) {
+        char buffer[64];
+        int length = snprintf(buffer, sizeof(buffer), "/api/v%d/region%d/node%lu", (int)(i % 3),
+            (int)(bench_random(&state) % 64), (unsigned long)i);
+        keys[i] = (char*)malloc(length + 1);
+        memcpy(keys[i], buffer, length + 1);
+        key_bytes += length + 1;
+    }
+    // probes are copies, so neither structure can get away with comparing pointers
+    for (long i = 0; i < ART_BENCH_LOOKUPS; i++) {
+        probes[i] = strdup(keys[bench_random(&state) % ART_BENCH_COUNT]);
+    }
+
+    ArtTree tree;
+    init_art(&tree);
+    long long start = now_ns();
+    for (long i = 0; i < ART_BENCH_COUNT; i++) {
+        art_insert(&tree, keys[i], keys[i]);
+    }
+    long long insert_time = now_ns() - start;
+
+    long buckets = 1;
+    while (buckets < ART_BENCH_COUNT) {
+        buckets <<= 1;
+    }
+    BenchStringNode **table = (BenchStringNode**)calloc(buckets, sizeof(BenchStringNode*));
+    BenchStringNode *nodes = (BenchStringNode*)malloc(ART_BENCH_COUNT * sizeof(BenchStringNode));
+    for (long i = 0; i < ART_BENCH_COUNT; i++) {
+        long bucket = (long)(bench_string_hash(keys[i]) & (buckets - 1));
+        nodes[i].key = keys[i];
+        nodes[i].data = keys[i];
+        nodes[i].next = table[bucket];
+        table[bucket] = &nodes[i];
+    }
+
+    long found_tree = 0;
+    long found_hash = 0;
+    start = now_ns();
+    for (long i = 0; i < ART_BENCH_LOOKUPS; i++) {
+        found_tree += art_lookup(&tree, probes[i]) != NULL;
+    }
+    long long tree_time = now_ns() - start;
+
+    start = now_ns();
+    for (long i = 0; i < ART_BENCH_LOOKUPS; i++) {
+        BenchStringNode *node = table[bench_string_hash(probes[i]) & (buckets - 1)];
+        while (node != NULL && strcmp(node->key, probes[i]) != 0) {
+            node = node->next;
+        }
+        found_hash += node != NULL;
+    }
+    long long hash_time = now_ns() - start;
+
+    printf("\nAdaptive radix tree benchmark (%d keys, %.1f MB of key data, insert %.2f ms):\n",
+        ART_BENCH_COUNT, key_bytes / 1e6, insert_time / 1e6);
+    printf("point lookups: ART %6.1f ns, chained hash map %6.1f ns %s\n", (double)tree_time / ART_BENCH_LOOKUPS,
+        (double)hash_time / ART_BENCH_LOOKUPS, found_tree == found_hash ? "" : "(mismatch)");
+
+    free_art(&tree);
+    free(table);
+    free(nodes);
+    for (long i = 0; i < ART_BENCH_COUNT; i++) {
+        free(keys[i]);
+    }
+    for (long i = 0; i < ART_BENCH_LOOKUPS; i++) {
+        free(probes[i]);
+    }
+    free(keys);
+    free(probes);
+}
+
+// main
+int main(int argc, char* argv[]) {
+    BTree tree;
+    init_btree(&tree);
+
+    int64_t values[] = { 50, 20, 80, 10, 30, 70, 90, 60, 40 };
+    for (int i = 0; i < 9; i++) {
+        btree_insert(&tree, values[i], values[i] * 10);
+    }
+    display_btree(&tree);
+
+    int64_t value;
+    if (btree_lookup(&tree, 30, &value)) {
+        printf("\nValue for 30: %lld\n", (long long)value);
+    }
+
+    btree_delete(&tree, 50);
+    display_btree(&tree);
+
+    printf("\nKeys in [25, 75):");
+    for (BTreeIterator it = btree_lower_bound(&tree, 25); btree_iter_valid(&it) && btree_iter_key(&it) < 75; btree_iter_next(&it)) {
+        printf(" %lld", (long long)btree_iter_key(&it));
+    }
+    printf("\n");
+
+    free_btree(&tree);
+
+    ArtTree routes;
+    init_art(&routes);
+    art_insert(&routes, "/api/users", "users");
+    art_insert(&routes, "/api/users/settings", "settings");
+    art_insert(&routes, "/api/orders", "orders");
+    art_insert(&routes, "/static/app.js", "script");
+    art_insert(&routes, "/", "index");
+
+    printf("\nRoute for /api/orders: %s\n", art_lookup(&routes, "/api/orders"));
+
+    printf("\nRoutes in order:\n");
+    art_iterate(&routes, art_print_key, NULL);
+
+    printf("\nRoutes starting with /api/users:\n");
+    art_iterate_prefix(&routes, "/api/users", art_print_key, NULL);
+
+    art_delete(&routes, "/api/users");
+    printf("\nRoutes starting with /api after deleting /api/users:\n");
+    art_iterate_prefix(&routes, "/api", art_print_key, NULL);
+
+    free_art(&routes);
+
+    // benchmarks only run when asked for: ./tree bench
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        btree_benchmark();
+        art_benchmark();
+    }
+
+    return 0;
+}